@@ -2,4 +2,5 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     ../qloggerlib \
-    ../qloggertester
+    ../qloggertester \
+    ../qloggerdecoder
@@ -0,0 +1,138 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+
+#include "binarylog.h"
+#include "logtextmask.h"
+#include "timestampformatter.h"
+
+using namespace qlogger;
+
+//!
+//! qloggerdecoder - writes the logs of binary log files (outputType=BINARY) to stdout as text, using a log
+//! text mask like the text outputs, or as json like the json output.
+//!
+//! qloggerdecoder [--json] [--mask <mask>] [--timestamp <format>] [--utc] <files...>
+//! use - as the file name to read stdin, for example: zcat log.qlog.gz | qloggerdecoder -
+//!
+
+//! writes the logs of a file, returns false if the file could not be read
+static bool decodeFile(const QString &fileName, QTextStream &out, QTextStream &err, bool json,
+                       const LogTextMask &mask, TimestampFormatter &timestampFormatter, bool &firstJson)
+{
+    QFile file(fileName);
+    bool opened = false;
+    if(fileName == QLatin1String("-"))
+        opened = file.open(stdin, QIODevice::ReadOnly);
+    else
+        opened = file.open(QIODevice::ReadOnly);
+    if(!opened)
+    {
+        err << fileName << ": " << file.errorString() << '\n';
+        return false;
+    }
+
+    BinaryLogReader reader(&file);
+    BinaryLogEntry entry;
+    QString line;
+    while(reader.next(entry))
+    {
+        const QString &timestamp = timestampFormatter.format(entry.timestamp);
+        if(json)
+        {
+            QJsonObject object;
+            object.insert(QStringLiteral("owner"), entry.owner);
+            object.insert(QStringLiteral("level"), levelToString(entry.level));
+            object.insert(QStringLiteral("message"), entry.message);
+            object.insert(QStringLiteral("dateTime"), timestamp);
+            object.insert(QStringLiteral("function"), entry.functionName);
+            object.insert(QStringLiteral("line"), entry.lineNumber);
+            out << (firstJson ? "\n" : ",\n") << QJsonDocument(object).toJson(QJsonDocument::Compact);
+            firstJson = false;
+        }
+        else
+        {
+            line.resize(0);
+            mask.format(line, entry.message, entry.owner, levelToString(entry.level), timestamp,
+                        entry.functionName, entry.lineNumber);
+            out << line << '\n';
+        }
+    }
+
+    if(reader.hasError())
+    {
+        err << fileName << ": " << reader.errorString() << '\n';
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("qloggerdecoder");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes qlogger binary log files as text or json.");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "Writes the logs as json instead of text.");
+    QCommandLineOption maskOption("mask", "The log text mask, symbols %t %o %l %f %n %m.", "mask", DEFAULT_TEXT_MASK);
+    QCommandLineOption timestampOption("timestamp", "The Qt date time format of the log time.", "format",
+                                       DEFAULT_TIMESTAMP_FORMAT);
+    QCommandLineOption utcOption("utc", "Writes the log time in UTC instead of local time.");
+    parser.addOption(jsonOption);
+    parser.addOption(maskOption);
+    parser.addOption(timestampOption);
+    parser.addOption(utcOption);
+    parser.addPositionalArgument("files", "The binary log files, - reads stdin.", "<files...>");
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if(files.isEmpty())
+        parser.showHelp(1);
+
+    QFile stdoutFile;
+    stdoutFile.open(stdout, QIODevice::WriteOnly);
+    QTextStream out(&stdoutFile);
+    out.setCodec("UTF-8");
+    QTextStream err(stderr);
+
+    bool json = parser.isSet(jsonOption);
+    LogTextMask mask(parser.value(maskOption));
+    TimestampFormatter timestampFormatter(parser.value(timestampOption), parser.isSet(utcOption));
+    bool firstJson = true;
+    bool ok = true;
+
+    if(json)
+        out << JSON_FILE_START;
+    for(const QString &fileName : files)
+        ok = decodeFile(fileName, out, err, json, mask, timestampFormatter, firstJson) && ok;
+    if(json)
+        out << '\n' << JSON_FILE_END << '\n';
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,16 @@
+QT -= gui
+
+CONFIG += console warn_on depend_includepath
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = qloggerdecoder
+
+SOURCES += main.cpp
+
+win32:CONFIG(release, debug|release): LIBS += -L$$OUT_PWD/../qloggerlib/release/ -lqloggerlib
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$OUT_PWD/../qloggerlib/debug/ -lqloggerlib
+else:unix: LIBS += -L$$OUT_PWD/../qloggerlib/ -lqloggerlib
+
+INCLUDEPATH += $$PWD/../qloggerlib
+DEPENDPATH += $$PWD/../qloggerlib
@@ -0,0 +1,180 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "asyncbackend.h"
+
+#include "output.h"
+#include "qlogger.h"
+
+namespace qlogger
+{
+
+//! how many records are written with a single acquisition of the write mutex
+static const int BACKEND_BATCH_SIZE = 256;
+
+//! max time the backend sleeps before checking the queue again
+static const unsigned long BACKEND_IDLE_WAIT_MS = 100;
+
+AsyncBackend::AsyncBackend(int capacity, Output *output) : queue(static_cast<size_t>(capacity)), output(output),
+    running(false), sleeping(false)
+{
+}
+
+AsyncBackend::~AsyncBackend()
+{
+    stop();
+    drain();
+}
+
+void AsyncBackend::push(LogRecord &record)
+{
+    while(!tryPush(record))
+    {
+        wake(); // the queue is full, make sure the backend is working on it
+        QThread::yieldCurrentThread();
+    }
+}
+
+bool AsyncBackend::tryPush(LogRecord &record)
+{
+    if(!queue.tryPush(record))
+        return false;
+
+    // pairs with the fence on run(), either we see the backend sleeping or it sees our record
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(sleeping.load(std::memory_order_relaxed))
+        wake();
+    return true;
+}
+
+void AsyncBackend::startBackend()
+{
+    if(!isRunning())
+    {
+        running.store(true);
+        start();
+    }
+}
+
+void AsyncBackend::stop()
+{
+    if(isRunning())
+    {
+        running.store(false);
+        wake();
+        wait();
+    }
+}
+
+void AsyncBackend::drain()
+{
+    while(drainBatch(BACKEND_BATCH_SIZE) > 0) {}
+}
+
+void AsyncBackend::run()
+{
+    while(running.load() || !queue.isEmpty())
+    {
+        if(drainBatch(BACKEND_BATCH_SIZE) > 0)
+            continue;
+
+        // nothing to write, a good moment to flush what waited too long on the buffers
+        {
+            QMutexLocker locker(writeMutex());
+            if(output != nullptr)
+                output->flushIfDue(currentTimestamp());
+            else
+                QLogger::flushDue(currentTimestamp());
+        }
+
+        QMutexLocker locker(&sleepMutex);
+        sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(running.load() && queue.isEmpty())
+            wakeUp.wait(&sleepMutex, BACKEND_IDLE_WAIT_MS);
+        sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+int AsyncBackend::drainBatch(int maxRecords)
+{
+    int count = 0;
+    if(queue.isEmpty())
+        return count;
+
+    // records are only popped with the write mutex held, so QLogger::flush sees them all written
+    if(batch.size() < maxRecords)
+        batch.resize(maxRecords);
+    {
+        QMutexLocker locker(writeMutex());
+        while(count < maxRecords && queue.tryPop(batch[count]))
+            count++;
+
+        // the outputs get the whole batch, the file outputs write it with a single call
+        if(output != nullptr)
+            output->writeBatch(batch.data(), count);
+        else
+            QLogger::dispatchBatch(batch.data(), count);
+    }
+
+    // the vector is kept for the next batch, but not the messages and arguments of this one
+    for(int i = 0; i < count; ++i)
+        batch[i] = LogRecord();
+    return count;
+}
+
+void AsyncBackend::waitUntilEmpty()
+{
+    while(isRunning() && !queue.isEmpty())
+    {
+        wake();
+        QThread::yieldCurrentThread();
+    }
+}
+
+void AsyncBackend::flushOutput()
+{
+    if(output == nullptr)
+        return;
+
+    if(isRunning())
+        waitUntilEmpty();
+    else
+        drain();
+
+    // the last batch popped is written with the mutex held, taking it waits for that batch too
+    QMutexLocker locker(output->getMutex());
+    output->flushPending();
+}
+
+QMutex *AsyncBackend::writeMutex()
+{
+    return output != nullptr ? output->getMutex() : &QLogger::writex;
+}
+
+void AsyncBackend::wake()
+{
+    QMutexLocker locker(&sleepMutex);
+    wakeUp.wakeOne();
+}
+
+}
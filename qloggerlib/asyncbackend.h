@@ -0,0 +1,154 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef ASYNCBACKEND_H
+#define ASYNCBACKEND_H
+
+#include <atomic>
+
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+#include "logqueue.h"
+#include "logrecord.h"
+
+namespace qlogger
+{
+
+class Output;
+
+//!
+//! \brief The AsyncBackend class - the dedicated thread used by qlogger on asynchronous mode, the logging
+//! threads only push records into a bounded lock-free queue and this thread drains it into the outputs.
+//! An isolated output has a backend of its own, that writes only to it and holds the mutex of the output
+//! instead of the qlogger write mutex.
+//!
+class AsyncBackend final : public QThread
+{
+public:
+    //!
+    //! \brief AsyncBackend - creates the backend, the thread is not started here
+    //! \param capacity - the max number of records waiting to be written
+    //! \param output - the only output written by this backend, nullptr to write to the outputs of each owner
+    //!
+    explicit AsyncBackend(int capacity, Output *output = nullptr);
+    AsyncBackend() = delete;
+    //! stops the thread and writes any pending record
+    ~AsyncBackend();
+
+    //!
+    //! \brief push - hands a record to the backend, if the queue is full the caller yields until
+    //! there is room, so no record is ever dropped
+    //! \param record - the record to be written, it is moved into the queue
+    //!
+    void push(LogRecord &record);
+
+    //!
+    //! \brief tryPush - hands a record to the backend without waiting
+    //! \param record - the record to be written, it is moved into the queue when there is room
+    //! \return false if the queue is full
+    //!
+    bool tryPush(LogRecord &record);
+
+    //!
+    //! \brief startBackend - starts the backend thread
+    //!
+    void startBackend();
+
+    //!
+    //! \brief stop - stops the backend thread after all queued records were written
+    //!
+    void stop();
+
+    //!
+    //! \brief drain - writes every queued record on the calling thread, used after the thread stopped
+    //!
+    void drain();
+
+    //!
+    //! \brief waitUntilEmpty - waits until the backend took every queued record
+    //!
+    void waitUntilEmpty();
+
+    //!
+    //! \brief flushOutput - waits until the output of an isolated backend wrote every queued record and flushes it
+    //!
+    void flushOutput();
+
+protected:
+    //!
+    //! \brief run - the backend loop, drains the queue and sleeps when there is nothing to write
+    //!
+    void run() override;
+
+private:
+    //! pops and writes at most maxRecords records, returns how many were written
+    int drainBatch(int maxRecords);
+
+    //! wakes the backend if it is sleeping
+    void wake();
+
+    //! the mutex held while writing a batch, the qlogger write mutex or the one of the isolated output
+    QMutex* writeMutex();
+
+private:
+    //!
+    //! \brief queue - the records waiting to be written
+    //!
+    LogQueue<LogRecord> queue;
+
+    //!
+    //! \brief output - the output of an isolated backend, nullptr for the qlogger backend
+    //!
+    Output *const output;
+
+
+    //!
+    //! \brief batch - the records popped to be written together, reused by every batch and emptied after it
+    //!
+    QVector<LogRecord> batch;
+
+    //!
+    //! \brief running - false when the backend was asked to stop
+    //!
+    std::atomic<bool> running;
+
+    //!
+    //! \brief sleeping - true while the backend waits for new records
+    //!
+    std::atomic<bool> sleeping;
+
+    //!
+    //! \brief sleepMutex - guards the wait condition used to park the backend
+    //!
+    QMutex sleepMutex;
+
+    //!
+    //! \brief wakeUp - signaled by producers when the backend is sleeping
+    //!
+    QWaitCondition wakeUp;
+};
+
+}
+
+#endif // ASYNCBACKEND_H
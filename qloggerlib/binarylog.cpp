@@ -0,0 +1,134 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "binarylog.h"
+
+namespace qlogger
+{
+
+//! entries bigger than this are taken as a corrupted file
+static const quint64 MAX_ENTRY_SIZE = 256 * 1024 * 1024;
+
+BinaryLogReader::BinaryLogReader(QIODevice *device) : device(device), headerRead(false), lastTimestamp(0)
+{
+}
+
+bool BinaryLogReader::next(BinaryLogEntry &entry)
+{
+    if(!error.isEmpty() || (!headerRead && !readHeader()))
+        return false;
+
+    forever
+    {
+        quint64 size = 0;
+        if(!readVarint(size))
+            return false; // end of the file
+        if(size == 0 || size > MAX_ENTRY_SIZE)
+            return fail(QStringLiteral("invalid entry size"));
+
+        entryBuffer = device->read(static_cast<qint64>(size));
+        if(static_cast<quint64>(entryBuffer.size()) != size)
+            return fail(QStringLiteral("truncated entry"));
+
+        const char *it = entryBuffer.constData();
+        const char *end = it + entryBuffer.size();
+        char kind = *it++;
+        quint64 id = 0, length = 0, delta = 0, owner = 0, function = 0, line = 0;
+        if(kind == BINARY_STRING)
+        {
+            if(!qlogger::readVarint(it, end, id) || !qlogger::readVarint(it, end, length)
+                    || length > static_cast<quint64>(end - it) || id != static_cast<quint64>(strings.size()))
+                return fail(QStringLiteral("invalid string entry"));
+            strings.append(QString::fromUtf8(it, static_cast<int>(length)));
+        }
+        else if(kind == BINARY_RECORD)
+        {
+            if(end - it < 1)
+                return fail(QStringLiteral("invalid record entry"));
+            uchar lvl = static_cast<uchar>(*it++);
+            if(lvl >= NUM_LEVEL
+                    || !qlogger::readVarint(it, end, delta) || !qlogger::readVarint(it, end, owner)
+                    || !qlogger::readVarint(it, end, function) || !qlogger::readVarint(it, end, line)
+                    || !qlogger::readVarint(it, end, length) || length > static_cast<quint64>(end - it)
+                    || owner >= static_cast<quint64>(strings.size()) || function >= static_cast<quint64>(strings.size()))
+                return fail(QStringLiteral("invalid record entry"));
+
+            lastTimestamp += zigzagDecode(delta);
+            entry.level = static_cast<Level>(lvl);
+            entry.timestamp = lastTimestamp;
+            entry.owner = strings.at(static_cast<int>(owner));
+            entry.functionName = strings.at(static_cast<int>(function));
+            entry.lineNumber = static_cast<int>(zigzagDecode(line));
+            entry.message = QString::fromUtf8(it, static_cast<int>(length));
+            return true;
+        }
+        // unknown kinds are skipped, newer writers may add them
+    }
+}
+
+bool BinaryLogReader::hasError() const
+{
+    return !error.isEmpty();
+}
+
+QString BinaryLogReader::errorString() const
+{
+    return error;
+}
+
+bool BinaryLogReader::readHeader()
+{
+    headerRead = true;
+    QByteArray header = device->read(BINARY_LOG_MAGIC_SIZE + 1);
+    if(header.size() != BINARY_LOG_MAGIC_SIZE + 1 || !header.startsWith(BINARY_LOG_MAGIC))
+        return fail(QStringLiteral("not a qlogger binary log file"));
+    if(header.at(BINARY_LOG_MAGIC_SIZE) != BINARY_LOG_VERSION)
+        return fail(QStringLiteral("unsupported binary log version %1").arg(static_cast<int>(header.at(BINARY_LOG_MAGIC_SIZE))));
+    return true;
+}
+
+bool BinaryLogReader::readVarint(quint64 &value)
+{
+    value = 0;
+    char byte = 0;
+    for(int shift = 0; shift < 64; shift += 7)
+    {
+        if(!device->getChar(&byte))
+        {
+            if(shift != 0)
+                fail(QStringLiteral("truncated entry size"));
+            return false;
+        }
+        value |= static_cast<quint64>(static_cast<uchar>(byte) & 0x7f) << shift;
+        if((static_cast<uchar>(byte) & 0x80) == 0)
+            return true;
+    }
+    return fail(QStringLiteral("invalid entry size"));
+}
+
+bool BinaryLogReader::fail(const QString &error)
+{
+    this->error = error;
+    return false;
+}
+
+}
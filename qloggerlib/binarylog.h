@@ -0,0 +1,190 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef BINARYLOG_H
+#define BINARYLOG_H
+
+#include <QHash>
+#include <QIODevice>
+#include <QString>
+#include <QVector>
+
+#include "qloggerlib_global.h"
+
+//!
+//! The binary log file format written by BinaryOutput:
+//!
+//! the file starts with BINARY_LOG_MAGIC (7 bytes) and the BINARY_LOG_VERSION byte, then a sequence of
+//! entries, each one a varint with the entry size followed by the entry bytes. The first entry byte is its kind:
+//!
+//! BINARY_STRING   varint id, varint size, UTF-8 bytes - defines an interned string (owner or function name),
+//!                 ids start at 0 on each file and are defined before the first record using them
+//! BINARY_RECORD   level byte, zigzag varint timestamp delta (nanoseconds since the previous record of the
+//!                 file, the first one since epoch), varint owner id, varint function id, zigzag varint line
+//!                 number, varint message size, UTF-8 message bytes
+//!
+//! varints are unsigned LEB128 (7 bits per byte, low bits first), each file can be read on its own.
+//!
+namespace qlogger
+{
+
+//! the first bytes of a binary log file
+static const char BINARY_LOG_MAGIC[] = "QLOGBIN";
+static const int BINARY_LOG_MAGIC_SIZE = 7;
+
+//! the version of the format, written after the magic
+static const char BINARY_LOG_VERSION = 1;
+
+//! the kinds of entries of a binary log file
+enum BinaryEntryKind
+{
+    BINARY_STRING = 1, BINARY_RECORD = 2
+};
+
+//! appends an unsigned LEB128 varint
+inline void appendVarint(QByteArray &out, quint64 value)
+{
+    while(value >= 0x80)
+    {
+        out.append(static_cast<char>((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+//! maps signed values to unsigned ones so small negative values take few bytes
+inline quint64 zigzagEncode(qint64 value)
+{
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+//! reverts zigzagEncode
+inline qint64 zigzagDecode(quint64 value)
+{
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+//! reads a varint from a buffer, moving it forward, false if the buffer ends before the varint
+inline bool readVarint(const char *&it, const char *end, quint64 &value)
+{
+    value = 0;
+    for(int shift = 0; it != end && shift < 64; shift += 7)
+    {
+        uchar byte = static_cast<uchar>(*it++);
+        value |= static_cast<quint64>(byte & 0x7f) << shift;
+        if((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+//!
+//! \brief The BinaryLogEntry struct - a log read back from a binary log file
+//!
+struct BinaryLogEntry
+{
+    Level level = q1ERROR;
+    qint64 timestamp = 0; //! nanoseconds since epoch
+    QString owner;
+    QString functionName;
+    int lineNumber = -1;
+    QString message;
+};
+
+//!
+//! \brief The BinaryLogReader class - reads the logs of a binary log file written by BinaryOutput
+//!
+class BinaryLogReader final
+{
+public:
+    //!
+    //! \brief BinaryLogReader - creates a reader for an opened device, the device is not owned
+    //! \param device - the binary log file opened for reading
+    //!
+    explicit BinaryLogReader(QIODevice *device);
+    BinaryLogReader() = delete;
+
+    //! forbid copying
+    BinaryLogReader(const BinaryLogReader &) = delete;
+    BinaryLogReader& operator=(const BinaryLogReader&) = delete;
+
+    //!
+    //! \brief next - reads the next log of the file
+    //! \param entry - filled with the log
+    //! \return false at the end of the file or on an error, see hasError
+    //!
+    bool next(BinaryLogEntry &entry);
+
+    //!
+    //! \brief hasError - true if the file is not a binary log file or it is corrupted
+    //!
+    bool hasError() const;
+
+    //!
+    //! \brief errorString - what went wrong
+    //!
+    QString errorString() const;
+
+private:
+    //! reads the file header, once
+    bool readHeader();
+
+    //! reads a varint from the device, false at the end of the file
+    bool readVarint(quint64 &value);
+
+    //! sets the error and returns false
+    bool fail(const QString &error);
+
+private:
+    //!
+    //! \brief device - the file being read
+    //!
+    QIODevice *device;
+
+    //!
+    //! \brief headerRead - true after the header was checked
+    //!
+    bool headerRead;
+
+    //!
+    //! \brief strings - the interned strings defined so far, by id
+    //!
+    QVector<QString> strings;
+
+    //!
+    //! \brief lastTimestamp - the timestamp of the previous record
+    //!
+    qint64 lastTimestamp;
+
+    //!
+    //! \brief entryBuffer - reused to read each entry
+    //!
+    QByteArray entryBuffer;
+
+    //!
+    //! \brief error - empty unless the file could not be read
+    //!
+    QString error;
+};
+
+}
+
+#endif // BINARYLOG_H
@@ -0,0 +1,154 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "binaryoutput.h"
+
+#include "binarylog.h"
+#include "logger.h"
+#include "utf8.h"
+
+namespace qlogger
+{
+
+BinaryOutput::BinaryOutput(Configuration *cfg) : PlainTextOutput(cfg), lastTimestamp(0)
+{
+    this->configuration->setFileNameMask(BINARY_FILE_NAME_MASK);
+
+    // a reserved QByteArray keeps its memory on resize(0)
+    recordBuffer.reserve(256);
+    entryBuffer.reserve(256);
+    textBuffer.reserve(256);
+}
+
+BinaryOutput::~BinaryOutput()
+{
+    PlainTextOutput::close();
+}
+
+void BinaryOutput::write(const LogRecord &record)
+{
+    if(record.level > configuration->getLogLevel()) // check level before writing
+        return;
+
+    if(!isFileOpen())
+        createNextFile();
+
+    encode(record);
+    if(!fits(recordBuffer.size()))
+    {
+        // the new file starts its own strings and timestamps, the log is encoded again for it
+        createNextFile();
+        encode(record);
+    }
+
+    if(!isFileOpen())
+        return;
+
+    writeBytes(recordBuffer);
+    written(record.level, recordBuffer.size(), record.timestamp);
+}
+
+void BinaryOutput::writeBatch(const LogRecord *records, int count)
+{
+    Output::writeBatch(records, count);
+}
+
+QIODevice::OpenMode BinaryOutput::fileOpenMode() const
+{
+    return PlainTextOutput::fileOpenMode() & ~QIODevice::Text;
+}
+
+void BinaryOutput::createNextFile()
+{
+    PlainTextOutput::createNextFile();
+    strings.clear();
+    siteFunctions.clear();
+    lastTimestamp = 0;
+
+    if(isFileOpen())
+    {
+        QByteArray header(BINARY_LOG_MAGIC, BINARY_LOG_MAGIC_SIZE);
+        header.append(BINARY_LOG_VERSION);
+        writeBytes(header);
+    }
+}
+
+void BinaryOutput::encode(const LogRecord &record)
+{
+    recordBuffer.resize(0);
+    quint64 ownerId = intern(record.logger->getOwner());
+    quint64 functionId = record.site != nullptr ? internFunction(record.site) : intern(record.functionName);
+
+    entryBuffer.resize(0);
+    entryBuffer.append(static_cast<char>(BINARY_RECORD));
+    entryBuffer.append(static_cast<char>(record.level));
+    appendVarint(entryBuffer, zigzagEncode(record.timestamp - lastTimestamp));
+    appendVarint(entryBuffer, ownerId);
+    appendVarint(entryBuffer, functionId);
+    appendVarint(entryBuffer, zigzagEncode(record.lineNumber));
+    // the message is the only part encoded on every log, straight into its place
+    textBuffer.resize(0);
+    appendUtf8(textBuffer, record.message);
+    appendVarint(entryBuffer, static_cast<quint64>(textBuffer.size()));
+    entryBuffer += textBuffer;
+    appendEntry();
+
+    lastTimestamp = record.timestamp;
+}
+
+quint64 BinaryOutput::internFunction(const CallSite *site)
+{
+    QHash<const CallSite*, quint64>::const_iterator it = siteFunctions.constFind(site);
+    if(it != siteFunctions.constEnd())
+        return it.value();
+
+    quint64 id = intern(site->functionName());
+    siteFunctions.insert(site, id);
+    return id;
+}
+
+quint64 BinaryOutput::intern(const QString &text)
+{
+    QHash<QString, quint64>::const_iterator it = strings.constFind(text);
+    if(it != strings.constEnd())
+        return it.value();
+
+    quint64 id = static_cast<quint64>(strings.size());
+    strings.insert(text, id);
+
+    entryBuffer.resize(0);
+    entryBuffer.append(static_cast<char>(BINARY_STRING));
+    appendVarint(entryBuffer, id);
+    QByteArray bytes = text.toUtf8();
+    appendVarint(entryBuffer, static_cast<quint64>(bytes.size()));
+    entryBuffer.append(bytes);
+    appendEntry();
+    return id;
+}
+
+void BinaryOutput::appendEntry()
+{
+    appendVarint(recordBuffer, static_cast<quint64>(entryBuffer.size()));
+    recordBuffer.append(entryBuffer);
+}
+
+}
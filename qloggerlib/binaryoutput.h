@@ -0,0 +1,115 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef BINARYOUTPUT_H
+#define BINARYOUTPUT_H
+
+#include <QHash>
+
+#include "textoutput.h"
+
+namespace qlogger
+{
+
+//!
+//! \brief The BinaryOutput class - saves the logs on a compact binary file, numbers and times are not turned
+//! into text and the owner and function names are written once per file, see binarylog.h for the format
+//! and the qloggerdecoder tool to read the files back as text or json.
+//!
+class BinaryOutput : public PlainTextOutput
+{
+public:
+    //!
+    //! \brief BinaryOutput
+    //! \param cfg
+    //!
+    BinaryOutput(Configuration *cfg);
+    BinaryOutput() = delete;
+    //!
+    ~BinaryOutput();
+
+    //!
+    //! \brief write - encodes the log and writes it to the binary file
+    //! \param record
+    //!
+    void write(const LogRecord &record);
+
+    //! writes the logs one by one, a binary log is encoded against the strings of its file
+    void writeBatch(const LogRecord *records, int count);
+
+protected:
+    //!
+    //! \brief createNextFile - creates the next file and writes the binary log header, the strings and the
+    //! timestamps start over on each file
+    //!
+    void createNextFile();
+
+    //! the binary files are never opened in text mode
+    QIODevice::OpenMode fileOpenMode() const;
+
+private:
+    //! encodes the log into recordBuffer, with the definition of any string new to the file
+    void encode(const LogRecord &record);
+
+    //! returns the id of the string on the current file, defining it on recordBuffer when it is new
+    quint64 intern(const QString &text);
+
+    //! returns the id of the function of a call site, the site address is looked up instead of the name
+    quint64 internFunction(const CallSite *site);
+
+    //! adds an entry to recordBuffer with its size before it
+    void appendEntry();
+
+private:
+    //!
+    //! \brief strings - the ids of the strings already defined on the current file
+    //!
+    QHash<QString, quint64> strings;
+
+    //!
+    //! \brief siteFunctions - the ids of the function names of the call sites already seen on the current file
+    //!
+    QHash<const CallSite*, quint64> siteFunctions;
+
+    //!
+    //! \brief lastTimestamp - the timestamp of the last record of the current file
+    //!
+    qint64 lastTimestamp;
+
+    //!
+    //! \brief recordBuffer - reused to encode each log with the strings it defines
+    //!
+    QByteArray recordBuffer;
+
+    //!
+    //! \brief entryBuffer - reused to encode a single entry
+    //!
+    QByteArray entryBuffer;
+
+    //!
+    //! \brief textBuffer - reused to encode the message as UTF-8
+    //!
+    QByteArray textBuffer;
+};
+
+}
+
+#endif // BINARYOUTPUT_H
@@ -0,0 +1,108 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef CALLSITE_H
+#define CALLSITE_H
+
+#include <atomic>
+
+#include <QString>
+
+#include "qloggerlib_global.h"
+
+namespace qlogger
+{
+
+class Logger;
+
+//!
+//! \brief The LoggerCache class - remembers the owner entry used by a log call site, every macro expansion
+//! has its own static cache so after the first call the level check needs no lock, lookup or allocation.
+//! It is constant initialized, so the static costs no guard on each call. resolve is defined on qlogger.h.
+//!
+class LoggerCache final
+{
+public:
+    constexpr LoggerCache() : logger(nullptr) {}
+
+    //!
+    //! \brief resolve - returns the entry of the owner, looking it up only when the owner changed
+    //! \param owner - the name of the log owner
+    //!
+    template <typename Owner>
+    inline const Logger* resolve(const Owner &owner);
+
+    //! resolves the default "root" owner
+    inline const Logger* resolve();
+
+private:
+    std::atomic<Logger*> logger;
+};
+
+//!
+//! \brief The CallSite struct - the constant description of a log call, each QLOG_* macro expansion defines
+//! one as a function-local static and the records only carry a pointer to it. Nothing is built on the log
+//! call, the function name becomes a QString once, the first time a log of the site is written, and the
+//! address of the site is a stable identity for it.
+//!
+struct CallSite final
+{
+    //!
+    //! \brief CallSite - a constant expression, so a static call site costs no guard
+    //! \param function - the function name (__FUNCTION__)
+    //! \param file - the source file (__FILE__)
+    //! \param line - the line number (__LINE__)
+    //! \param level - the level of the log
+    //!
+    constexpr CallSite(const char *function, const char *file, int line, Level level) :
+        function(function), file(file), line(line), level(level), name(nullptr) {}
+    CallSite(const CallSite&) = delete;
+    CallSite& operator=(const CallSite&) = delete;
+
+    //!
+    //! \brief functionName - the function name as a QString, built by the first call and kept for the life
+    //! of the program
+    //!
+    const QString &functionName() const;
+
+    //! the function where the log is
+    const char *const function;
+
+    //! the source file where the log is
+    const char *const file;
+
+    //! the line where the log is
+    const int line;
+
+    //! the level of the log
+    const Level level;
+
+    //! the owner entry of the QLOG_* macros that take the owner name
+    LoggerCache owner;
+
+private:
+    //! the function name built by functionName, nullptr before the first call
+    mutable std::atomic<const QString*> name;
+};
+
+}
+
+#endif // CALLSITE_H
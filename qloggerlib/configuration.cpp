@@ -22,9 +22,31 @@
 
 #include "configuration.h"
 
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStringBuilder>
+
 namespace qlogger
 {
 
+//! gives the same number to the same text mask and timestamp format, configurations are changed seldom
+static int internFormat(const QString &textMask, const QString &timestampFormat, bool utc)
+{
+    static QMutex mutex;
+    static QHash<QString, int> ids;
+
+    const QString key = textMask % QChar(0) % timestampFormat % QLatin1Char(utc ? 'u' : 'l');
+    QMutexLocker locker(&mutex);
+    QHash<QString, int>::const_iterator it = ids.constFind(key);
+    if(it != ids.constEnd())
+        return it.value();
+
+    const int id = ids.size();
+    ids.insert(key, id);
+    return id;
+}
+
 Configuration::Configuration(QString logOwner,
                              Level lvl,
                              QString textMask,
@@ -34,15 +56,73 @@ Configuration::Configuration(QString logOwner,
                              QString path,
                              qint64 maxSizeInBytes)
     : logOwner(std::move(logOwner)), logLevel(lvl),
-      logTextMask(std::move(textMask)), timestampFormat(std::move(timestampFormat)),
+      logTextMask(std::move(textMask)), compiledTextMask(logTextMask), timestampFormat(std::move(timestampFormat)), timestampUtc(false),
       fileNameMask(std::move(fileMask)), fileNameTimestampFormat(std::move(fileTimestampFormat)),
-      filePath(std::move(path)), fileMaxSizeInBytes(maxSizeInBytes)
+      filePath(std::move(path)), fileMaxSizeInBytes(maxSizeInBytes),
+      flushBufferSize(DEFAULT_FLUSH_POLICY), flushInterval(DEFAULT_FLUSH_POLICY), flushLevel(DEFAULT_FLUSH_POLICY),
+      compression(NO_COMPRESSION), maxTotalSize(NO_RETENTION_LIMIT), maxFiles(NO_RETENTION_LIMIT),
+      maxAgeDays(NO_RETENTION_LIMIT), jsonFormat(JSON_DOCUMENT),
+      isolatedQueueCapacity(NOT_ISOLATED), nativeLineEndings(true)
 {
+    // the parameter was moved into the member
+    timestampFormatter = TimestampFormatter(this->timestampFormat, timestampUtc);
+    fileNameTimestampFormatter = TimestampFormatter(fileNameTimestampFormat, timestampUtc);
+    updateFormatId();
+}
+
+Configuration::Configuration(const Configuration &other)
+    : logOwner(other.logOwner), logLevel(other.logLevel.load(std::memory_order_relaxed)),
+      logTextMask(other.logTextMask), compiledTextMask(other.compiledTextMask), timestampFormat(other.timestampFormat),
+      timestampUtc(other.timestampUtc), formatId(other.formatId),
+      fileNameMask(other.fileNameMask), fileNameTimestampFormat(other.fileNameTimestampFormat),
+      timestampFormatter(other.timestampFormatter), fileNameTimestampFormatter(other.fileNameTimestampFormatter),
+      filePath(other.filePath), fileMaxSizeInBytes(other.fileMaxSizeInBytes),
+      flushBufferSize(other.flushBufferSize), flushInterval(other.flushInterval), flushLevel(other.flushLevel),
+      compression(other.compression), maxTotalSize(other.maxTotalSize), maxFiles(other.maxFiles),
+      maxAgeDays(other.maxAgeDays), jsonFormat(other.jsonFormat),
+      isolatedQueueCapacity(other.isolatedQueueCapacity), nativeLineEndings(other.nativeLineEndings)
+{
+}
+
+Configuration &Configuration::operator=(const Configuration &other)
+{
+    if(this == &other)
+        return *this;
+
+    logOwner = other.logOwner;
+    logLevel.store(other.logLevel.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    logTextMask = other.logTextMask;
+    compiledTextMask = other.compiledTextMask;
+    timestampFormat = other.timestampFormat;
+    timestampUtc = other.timestampUtc;
+    formatId = other.formatId;
+    fileNameMask = other.fileNameMask;
+    fileNameTimestampFormat = other.fileNameTimestampFormat;
+    timestampFormatter = other.timestampFormatter;
+    fileNameTimestampFormatter = other.fileNameTimestampFormatter;
+    filePath = other.filePath;
+    fileMaxSizeInBytes = other.fileMaxSizeInBytes;
+    flushBufferSize = other.flushBufferSize;
+    flushInterval = other.flushInterval;
+    flushLevel = other.flushLevel;
+    compression = other.compression;
+    maxTotalSize = other.maxTotalSize;
+    maxFiles = other.maxFiles;
+    maxAgeDays = other.maxAgeDays;
+    jsonFormat = other.jsonFormat;
+    isolatedQueueCapacity = other.isolatedQueueCapacity;
+    nativeLineEndings = other.nativeLineEndings;
+    return *this;
+}
+
+void Configuration::updateFormatId()
+{
+    formatId = internFormat(logTextMask, timestampFormat, timestampUtc);
 }
 
 bool Configuration::operator==(const Configuration &rh)
 {
-    return (this->logOwner == rh.logOwner && this->logLevel == rh.logLevel);
+    return (this->logOwner == rh.logOwner && this->getLogLevel() == rh.getLogLevel());
 }
 
 bool Configuration::validate()
@@ -60,6 +140,116 @@ void Configuration::setFileMaxSizeInBytes(qint64 value)
     fileMaxSizeInBytes = value;
 }
 
+qint64 Configuration::getFlushBufferSize() const
+{
+    return flushBufferSize;
+}
+
+void Configuration::setFlushBufferSize(qint64 value)
+{
+    flushBufferSize = value;
+}
+
+int Configuration::getFlushInterval() const
+{
+    return flushInterval;
+}
+
+void Configuration::setFlushInterval(int value)
+{
+    flushInterval = value;
+}
+
+int Configuration::getFlushLevel() const
+{
+    return flushLevel;
+}
+
+void Configuration::setFlushLevel(int value)
+{
+    flushLevel = value;
+}
+
+Compression Configuration::getCompression() const
+{
+    return compression;
+}
+
+void Configuration::setCompression(Compression value)
+{
+    compression = value;
+}
+
+qint64 Configuration::getMaxTotalSize() const
+{
+    return maxTotalSize;
+}
+
+void Configuration::setMaxTotalSize(qint64 value)
+{
+    maxTotalSize = value;
+}
+
+int Configuration::getMaxFiles() const
+{
+    return maxFiles;
+}
+
+void Configuration::setMaxFiles(int value)
+{
+    maxFiles = value;
+}
+
+int Configuration::getMaxAgeDays() const
+{
+    return maxAgeDays;
+}
+
+void Configuration::setMaxAgeDays(int value)
+{
+    maxAgeDays = value;
+}
+
+bool Configuration::hasRetention() const
+{
+    return maxTotalSize > 0 || maxFiles > 0 || maxAgeDays > 0;
+}
+
+JsonFormat Configuration::getJsonFormat() const
+{
+    return jsonFormat;
+}
+
+void Configuration::setJsonFormat(JsonFormat value)
+{
+    jsonFormat = value;
+}
+
+int Configuration::getIsolatedQueueCapacity() const
+{
+    return isolatedQueueCapacity;
+}
+
+void Configuration::setIsolatedQueueCapacity(int value)
+{
+    isolatedQueueCapacity = value;
+}
+
+bool Configuration::isIsolated() const
+{
+    return isolatedQueueCapacity > NOT_ISOLATED;
+}
+
+bool Configuration::isNativeLineEndings() const
+{
+    return nativeLineEndings;
+}
+
+void Configuration::setNativeLineEndings(bool value)
+{
+    nativeLineEndings = value;
+}
+
 QString Configuration::getFilePath() const
 {
     return filePath;
@@ -78,6 +268,12 @@ QString Configuration::getFileNameTimestampFormat() const
 void Configuration::setFileNameTimestampFormat(const QString &value)
 {
     fileNameTimestampFormat = value;
+    fileNameTimestampFormatter = TimestampFormatter(fileNameTimestampFormat, timestampUtc);
+}
+
+TimestampFormatter &Configuration::getFileNameTimestampFormatter()
+{
+    return fileNameTimestampFormatter;
 }
 
 QString Configuration::getFileNameMask() const
@@ -98,6 +294,18 @@ QString Configuration::getLogTextMask() const
 void Configuration::setLogTextMask(const QString &value)
 {
     logTextMask = value;
+    compiledTextMask = LogTextMask(logTextMask);
+    updateFormatId();
+}
+
+const LogTextMask &Configuration::getCompiledTextMask() const
+{
+    return compiledTextMask;
+}
+
+int Configuration::getFormatId() const
+{
+    return formatId;
 }
 
 QString Configuration::getTimestampFormat() const
@@ -108,16 +316,36 @@ QString Configuration::getTimestampFormat() const
 void Configuration::setTimestampFormat(const QString &value)
 {
     timestampFormat = value;
+    timestampFormatter = TimestampFormatter(timestampFormat, timestampUtc);
+    updateFormatId();
+}
+
+TimestampFormatter &Configuration::getTimestampFormatter()
+{
+    return timestampFormatter;
+}
+
+bool Configuration::isTimestampUtc() const
+{
+    return timestampUtc;
+}
+
+void Configuration::setTimestampUtc(bool value)
+{
+    timestampUtc = value;
+    timestampFormatter = TimestampFormatter(timestampFormat, timestampUtc);
+    fileNameTimestampFormatter = TimestampFormatter(fileNameTimestampFormat, timestampUtc);
+    updateFormatId();
 }
 
 Level Configuration::getLogLevel() const
 {
-    return logLevel;
+    return static_cast<Level>(logLevel.load(std::memory_order_relaxed));
 }
 
 void Configuration::setLogLevel(const Level &value)
 {
-    logLevel = value;
+    logLevel.store(static_cast<int>(value), std::memory_order_relaxed);
 }
 
 QString Configuration::getLogOwner() const
@@ -22,7 +22,11 @@
 #ifndef CONFIGURATION_H
 #define CONFIGURATION_H
 
+#include <atomic>
+
 #include "qloggerlib_global.h"
+#include "logtextmask.h"
+#include "timestampformatter.h"
 
 namespace qlogger
 {
@@ -62,6 +66,10 @@ public:
     //!destructor as default since not much to do here.
     ~Configuration() = default;
 
+    //! copies every field, the level is atomic so it is loaded and stored
+    Configuration(const Configuration &other);
+    Configuration& operator=(const Configuration &other);
+
     //!
     //! \brief operator == equals operator is used to check if a configuration have the same level and owner
     //! \param rh
@@ -86,21 +94,79 @@ public:
     QString getTimestampFormat() const;
     void setTimestampFormat(const QString &value);
 
+    bool isTimestampUtc() const;
+    void setTimestampUtc(bool value);
+
+    //! the timestamp format compiled for formatting log times, kept in sync with the format and utc flag
+    TimestampFormatter& getTimestampFormatter();
+
     QString getLogTextMask() const;
     void setLogTextMask(const QString &value);
 
+    //! the log text mask compiled for formatting, kept in sync with the log text mask
+    const LogTextMask& getCompiledTextMask() const;
+
+    //! the same number for every configuration with the same log text mask and timestamp format, outputs with
+    //! the same id format a log to the same text, so it is formatted once for all of them
+    int getFormatId() const;
+
     QString getFileNameMask() const;
     void setFileNameMask(const QString &value);
 
     QString getFileNameTimestampFormat() const;
     void setFileNameTimestampFormat(const QString &value);
 
+    //! the file name timestamp format compiled for formatting, kept in sync with the format
+    TimestampFormatter& getFileNameTimestampFormatter();
+
     QString getFilePath() const;
     void setFilePath(const QString &value);
 
     qint64 getFileMaxSizeInBytes() const;
     void setFileMaxSizeInBytes(qint64 value);
 
+    qint64 getFlushBufferSize() const;
+    void setFlushBufferSize(qint64 value);
+
+    int getFlushInterval() const;
+    void setFlushInterval(int value);
+
+    int getFlushLevel() const;
+    void setFlushLevel(int value);
+
+    Compression getCompression() const;
+    void setCompression(Compression value);
+
+    qint64 getMaxTotalSize() const;
+    void setMaxTotalSize(qint64 value);
+
+    int getMaxFiles() const;
+    void setMaxFiles(int value);
+
+    int getMaxAgeDays() const;
+    void setMaxAgeDays(int value);
+
+    //! true if any retention limit is set
+    bool hasRetention() const;
+
+    JsonFormat getJsonFormat() const;
+    void setJsonFormat(JsonFormat value);
+
+    //! the number of logs that can wait for an isolated output, NOT_ISOLATED for outputs written with the others
+    int getIsolatedQueueCapacity() const;
+    void setIsolatedQueueCapacity(int value);
+
+    //! true if the output is written by a thread of its own
+    bool isIsolated() const;
+
+    //! true (default) if the text files end their lines as the platform does, \r\n on windows
+    bool isNativeLineEndings() const;
+    void setNativeLineEndings(bool value);
+
+private:
+    //! takes the format id of the current text mask and timestamp format
+    void updateFormatId();
+
 private:
 
     //!
@@ -109,20 +175,36 @@ private:
     QString logOwner;
 
     //!
-    //! \brief logLevel - level of this configuration
+    //! \brief logLevel - level of this configuration, read by the logging threads without the output mutex
+    //! so a reload of the configuration file can change it on a running output
     //!
-    Level logLevel;
+    std::atomic<int> logLevel;
 
     //!
     //! \brief logTextMask - the actual log text mask, used only for plain text logs outputs
     //!
     QString logTextMask;
 
+    //!
+    //! \brief compiledTextMask - logTextMask compiled once, so each log does a single append pass
+    //!
+    LogTextMask compiledTextMask;
+
     //!
     //! \brief timestampFormat - the date time format to be displayed on the log text it must use Qt Date Time format convention
     //!
     QString timestampFormat;
 
+    //!
+    //! \brief timestampUtc - writes the log time in UTC instead of local time, saving the time zone conversion
+    //!
+    bool timestampUtc;
+
+    //!
+    //! \brief formatId - identifies logTextMask, timestampFormat and timestampUtc together, see getFormatId
+    //!
+    int formatId;
+
     //!
     //! \brief fileNameMask - the mask for a file name of the log file
     //!
@@ -133,6 +215,16 @@ private:
     //!
     QString fileNameTimestampFormat;
 
+    //!
+    //! \brief timestampFormatter - timestampFormat compiled once, caches the text of the current second
+    //!
+    TimestampFormatter timestampFormatter;
+
+    //!
+    //! \brief fileNameTimestampFormatter - fileNameTimestampFormat compiled once
+    //!
+    TimestampFormatter fileNameTimestampFormatter;
+
     //!
     //! \brief filePath - the path were this log file will be saved
     //!
@@ -143,6 +235,61 @@ private:
     //!
     qint64 fileMaxSizeInBytes;
 
+    //!
+    //! \brief flushBufferSize - bytes written before the output is flushed, 0 flushes every log,
+    //! DEFAULT_FLUSH_POLICY lets the output decide (console flushes every log, files buffer)
+    //!
+    qint64 flushBufferSize;
+
+    //!
+    //! \brief flushInterval - max milliseconds a written log waits to be flushed, 0 to not flush by time,
+    //! DEFAULT_FLUSH_POLICY lets the output decide
+    //!
+    int flushInterval;
+
+    //!
+    //! \brief flushLevel - logs of this level or more severe are flushed right away,
+    //! DEFAULT_FLUSH_POLICY lets the output decide
+    //!
+    int flushLevel;
+
+    //!
+    //! \brief compression - how finished log files are compressed by the file worker
+    //!
+    Compression compression;
+
+    //!
+    //! \brief maxTotalSize - max bytes of all the log files of the owner together, the oldest are removed
+    //!
+    qint64 maxTotalSize;
+
+    //!
+    //! \brief maxFiles - max number of log files of the owner, the oldest are removed
+    //!
+    int maxFiles;
+
+    //!
+    //! \brief maxAgeDays - log files not written for more days than this are removed
+    //!
+    int maxAgeDays;
+
+    //!
+    //! \brief jsonFormat - a single json document per file, or one json log per line (NDJSON)
+    //!
+    JsonFormat jsonFormat;
+
+    //!
+    //! \brief isolatedQueueCapacity - gives the output its own queue and writer thread, so a slow io does not
+    //! hold the other outputs, logs that find the queue full are dropped and counted. NOT_ISOLATED by default
+    //!
+    int isolatedQueueCapacity;
+
+    //!
+    //! \brief nativeLineEndings - the text files are opened in text mode, so lines end with \r\n on windows,
+    //! false writes \n on every platform. True by default
+    //!
+    bool nativeLineEndings;
+
 };
 
 
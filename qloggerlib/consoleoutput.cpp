@@ -24,6 +24,7 @@
 #include <QDateTime>
 
 #include "configuration.h"
+#include "rendercache.h"
 
 namespace qlogger
 {
@@ -38,19 +39,25 @@ ConsoleOutput::~ConsoleOutput()
     close();
 }
 
-void ConsoleOutput::write(const QString message,
-                          const QString owner,
-                          const Level lvl,
-                          const QDateTime timestamp,
-                          const QString functionName,
-                          const int lineNumber)
+void ConsoleOutput::write(const LogRecord &record)
 {
-    if(lvl <= configuration->getLogLevel()) // check level before writing
-        *outputStream << formatLogText(configuration->getLogTextMask(),
-                                       message, owner,
-                                       levelToString(lvl),
-                                       timestamp.toString(configuration->getTimestampFormat()),
-                                       functionName, lineNumber) << endl;
+    if(record.level <= configuration->getLogLevel()) // check level before writing
+    {
+        const QString &line = formatLine(record);
+        *outputStream << line << QLatin1Char('\n');
+        written(record.level, line.size() + 1, record.timestamp);
+    }
+}
+
+const QString &ConsoleOutput::formatLine(const LogRecord &record)
+{
+    // outputs of the owner with the same format share the text formatted by the first one
+    if(record.rendered != nullptr)
+        return record.rendered->text(record, *configuration);
+
+    lineBuffer.resize(0); // keeps the capacity
+    renderText(lineBuffer, record, *configuration);
+    return lineBuffer;
 }
 
 void ConsoleOutput::close()
@@ -58,5 +65,10 @@ void ConsoleOutput::close()
     outputStream->flush();
 }
 
+void ConsoleOutput::flush()
+{
+    outputStream->flush();
+}
+
 
 }
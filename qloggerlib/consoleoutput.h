@@ -51,28 +51,34 @@ public:
 
     //!
     //! \brief write - this method is responsible for write the log text in the selected output
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \param record
     //!
-    virtual void write(const QString message,
-                       const QString owner,
-                       const Level lvl,
-                       const QDateTime timestamp,
-                       const QString functionName,
-                       const int lineNumber);
+    virtual void write(const LogRecord &record);
 
     //! implemented from output
     virtual void close();
 
+    //! implemented from output
+    virtual void flush();
+
+protected:
+    //!
+    //! \brief formatLine - the log formatted with the text mask, without the line break, the text shared by the
+    //! other outputs of the owner or else formatted into lineBuffer
+    //! \param record
+    //!
+    const QString& formatLine(const LogRecord &record);
+
 protected:
     //!
     //! \brief outputStream - the qt class to output texts
     //!
     QSharedPointer<QTextStream> outputStream;
+
+    //!
+    //! \brief lineBuffer - reused to format each log text, keeps its memory between logs
+    //!
+    QString lineBuffer;
 };
 
 }
@@ -0,0 +1,113 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "filecompression.h"
+
+#include <QFile>
+
+namespace qlogger
+{
+
+//! size of the chunks read from the file, each one is a gzip member
+static const qint64 GZIP_CHUNK_SIZE = 1024 * 1024;
+
+//! the gzip member header: magic, deflate, no flags, no time, no extra flags, unknown os
+static const char GZIP_HEADER[] = { '\x1f', '\x8b', '\x08', '\x00', '\x00', '\x00', '\x00', '\x00', '\x00', '\xff' };
+
+//! qCompress writes a 4 bytes length, then a zlib stream of a 2 bytes header, the deflate data and a 4 bytes adler32
+static const int QCOMPRESS_PREFIX = 4 + 2;
+static const int QCOMPRESS_SUFFIX = 4;
+
+quint32 crc32(quint32 crc, const QByteArray &data)
+{
+    static const struct Table
+    {
+        quint32 values[256];
+        Table()
+        {
+            for(quint32 n = 0; n < 256; ++n)
+            {
+                quint32 c = n;
+                for(int k = 0; k < 8; ++k)
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                values[n] = c;
+            }
+        }
+    } table;
+
+    crc = ~crc;
+    const uchar *it = reinterpret_cast<const uchar*>(data.constData());
+    const uchar *end = it + data.size();
+    for(; it != end; ++it)
+        crc = table.values[(crc ^ *it) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+//! appends a 32 bits value as gzip stores it, little endian
+static void appendLittleEndian(QByteArray &out, quint32 value)
+{
+    for(int i = 0; i < 4; ++i)
+        out.append(static_cast<char>((value >> (8 * i)) & 0xff));
+}
+
+bool gzipFile(const QString &source, const QString &target, int level)
+{
+    QFile in(source);
+    QFile out(target);
+    if(!in.open(QIODevice::ReadOnly) || !out.open(QIODevice::WriteOnly))
+        return false;
+
+    QByteArray member;
+    bool ok = true;
+    while(ok && !in.atEnd())
+    {
+        QByteArray chunk = in.read(GZIP_CHUNK_SIZE);
+        if(chunk.isEmpty())
+        {
+            ok = in.atEnd();
+            break;
+        }
+
+        QByteArray compressed = qCompress(chunk, level);
+        if(compressed.size() < QCOMPRESS_PREFIX + QCOMPRESS_SUFFIX)
+        {
+            ok = false;
+            break;
+        }
+
+        member.resize(0);
+        member.append(GZIP_HEADER, sizeof(GZIP_HEADER));
+        member.append(compressed.constData() + QCOMPRESS_PREFIX,
+                      compressed.size() - QCOMPRESS_PREFIX - QCOMPRESS_SUFFIX);
+        appendLittleEndian(member, crc32(0, chunk));
+        appendLittleEndian(member, static_cast<quint32>(chunk.size()));
+        ok = out.write(member) == member.size();
+    }
+
+    out.close();
+    ok = ok && out.error() == QFileDevice::NoError;
+    if(!ok)
+        out.remove();
+    return ok;
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef FILECOMPRESSION_H
+#define FILECOMPRESSION_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace qlogger
+{
+
+//!
+//! \brief crc32 - the CRC-32 (IEEE) used by gzip, continued from a previous value
+//! \param crc - the crc of the previous bytes, 0 to start
+//! \param data
+//! \return the crc including data
+//!
+quint32 crc32(quint32 crc, const QByteArray &data);
+
+//!
+//! \brief gzipFile - compresses a file to a gzip file, reading it in chunks, each chunk is written as a gzip
+//! member so memory use does not depend on the file size (gunzip and zcat read the members as one file)
+//! \param source - the file to be compressed
+//! \param target - the gzip file to be created
+//! \param level - the zlib compression level, -1 for the zlib default
+//! \return true if the whole file was compressed, on failure the target is removed
+//!
+bool gzipFile(const QString &source, const QString &target, int level = -1);
+
+}
+
+#endif // FILECOMPRESSION_H
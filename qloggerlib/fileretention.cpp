@@ -0,0 +1,107 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "fileretention.h"
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace qlogger
+{
+
+//! milliseconds of a day
+static const qint64 DAY_MS = 24 * 60 * 60 * 1000;
+
+FileRetention::FileRetention(QString directory, QRegularExpression namePattern, qint64 maxTotalSize, int maxFiles,
+                             int maxAgeDays)
+    : directory(std::move(directory)), namePattern(std::move(namePattern)),
+      maxTotalSize(maxTotalSize), maxFiles(maxFiles), maxAgeDays(maxAgeDays), total(0)
+{
+}
+
+void FileRetention::scan(const QString &current)
+{
+    QDir dir(directory);
+    const QFileInfoList found = dir.entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+    for(const QFileInfo &info : found)
+    {
+        if(info.absoluteFilePath() == current || !namePattern.match(info.fileName()).hasMatch())
+            continue;
+        files.append(Entry{ info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch() });
+        total += info.size();
+    }
+}
+
+void FileRetention::track(const QString &fileName, qint64 reservedSize)
+{
+    files.append(Entry{ fileName, reservedSize, QDateTime::currentMSecsSinceEpoch() });
+    total += reservedSize;
+    prune();
+}
+
+void FileRetention::finished(const QString &fileName, const QString &finalName)
+{
+    for(Entry &entry : files)
+    {
+        if(entry.fileName != fileName)
+            continue;
+
+        QFileInfo info(finalName);
+        total += info.size() - entry.size;
+        entry.fileName = finalName;
+        entry.size = info.size();
+        entry.lastWrite = QDateTime::currentMSecsSinceEpoch();
+        return;
+    }
+}
+
+int FileRetention::fileCount() const
+{
+    return files.size();
+}
+
+qint64 FileRetention::totalSize() const
+{
+    return total;
+}
+
+void FileRetention::prune()
+{
+    const qint64 oldest = QDateTime::currentMSecsSinceEpoch() - maxAgeDays * DAY_MS;
+    while(files.size() > 1)
+    {
+        const Entry &entry = files.first();
+        bool overFiles = maxFiles > 0 && files.size() > maxFiles;
+        bool overSize = maxTotalSize > 0 && total > maxTotalSize;
+        bool overAge = maxAgeDays > 0 && entry.lastWrite < oldest;
+        if(!overFiles && !overSize && !overAge)
+            break;
+
+        QFile::remove(entry.fileName); // a file removed by someone else just leaves the index
+        total -= entry.size;
+        files.removeFirst();
+    }
+}
+
+}
@@ -0,0 +1,131 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef FILERETENTION_H
+#define FILERETENTION_H
+
+#include <QList>
+#include <QRegularExpression>
+#include <QString>
+
+namespace qlogger
+{
+
+//!
+//! \brief The FileRetention class - keeps the index of the log files of a file output and removes the oldest
+//! ones when there are too many, too big or too old. The index is seeded by a single directory scan and then
+//! kept by the output, all methods run on the file worker so the logging threads never touch the file system.
+//!
+class FileRetention final
+{
+public:
+    //!
+    //! \brief FileRetention - creates the retention for a log folder
+    //! \param directory - the folder of the log files
+    //! \param namePattern - matches the names of the log files of the output, used by the first scan
+    //! \param maxTotalSize - max bytes of all the log files together, 0 for no limit
+    //! \param maxFiles - max number of log files, 0 for no limit
+    //! \param maxAgeDays - log files not written for more days than this are removed, 0 for no limit
+    //!
+    FileRetention(QString directory, QRegularExpression namePattern, qint64 maxTotalSize, int maxFiles, int maxAgeDays);
+    FileRetention() = delete;
+
+    //! forbid copying
+    FileRetention(const FileRetention &) = delete;
+    FileRetention& operator=(const FileRetention&) = delete;
+
+    //!
+    //! \brief scan - seeds the index with the log files already on the folder, oldest first
+    //! \param current - the file being written, left out to be tracked as the newest
+    //!
+    void scan(const QString &current);
+
+    //!
+    //! \brief track - adds the file being written as the newest file and removes the files over the limits,
+    //! the file being written is never removed
+    //! \param fileName - the new file
+    //! \param reservedSize - the size counted for the file while it is written, the max file size
+    //!
+    void track(const QString &fileName, qint64 reservedSize);
+
+    //!
+    //! \brief finished - updates a file when it is closed (and compressed)
+    //! \param fileName - the file as it was tracked
+    //! \param finalName - the file as it stays on the disk, the compressed file
+    //!
+    void finished(const QString &fileName, const QString &finalName);
+
+    //!
+    //! \brief fileCount - number of files on the index
+    //!
+    int fileCount() const;
+
+    //!
+    //! \brief totalSize - bytes of the files on the index
+    //!
+    qint64 totalSize() const;
+
+private:
+    //! removes the oldest files while any limit is exceeded, always keeping the newest file
+    void prune();
+
+    //!
+    //! \brief The Entry struct - a log file on the index
+    //!
+    struct Entry
+    {
+        QString fileName;
+        qint64 size;
+        qint64 lastWrite; //! milliseconds since epoch
+    };
+
+private:
+    //!
+    //! \brief directory - the folder of the log files
+    //!
+    const QString directory;
+
+    //!
+    //! \brief namePattern - matches the names of the log files of the output, and no file of another owner
+    //!
+    const QRegularExpression namePattern;
+
+    //!
+    //! \brief maxTotalSize, maxFiles, maxAgeDays - the limits, 0 for no limit
+    //!
+    const qint64 maxTotalSize;
+    const int maxFiles;
+    const int maxAgeDays;
+
+    //!
+    //! \brief files - the log files, oldest first
+    //!
+    QList<Entry> files;
+
+    //!
+    //! \brief total - sum of the sizes of the files
+    //!
+    qint64 total;
+};
+
+}
+
+#endif // FILERETENTION_H
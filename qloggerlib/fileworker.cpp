@@ -0,0 +1,87 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "fileworker.h"
+
+namespace qlogger
+{
+
+QSharedPointer<FileWorker> FileWorker::acquire()
+{
+    static QMutex acquirex;
+    static QWeakPointer<FileWorker> current;
+
+    QMutexLocker locker(&acquirex);
+    QSharedPointer<FileWorker> worker = current.toStrongRef();
+    if(worker.isNull())
+    {
+        worker = QSharedPointer<FileWorker>(new FileWorker());
+        current = worker;
+        worker->start();
+    }
+    return worker;
+}
+
+FileWorker::FileWorker() : stopping(false)
+{
+}
+
+FileWorker::~FileWorker()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        hasTask.wakeOne();
+    }
+    wait();
+}
+
+void FileWorker::post(std::function<void()> task)
+{
+    QMutexLocker locker(&mutex);
+    tasks.enqueue(std::move(task));
+    hasTask.wakeOne();
+}
+
+void FileWorker::run()
+{
+    QMutexLocker locker(&mutex);
+    forever
+    {
+        if(tasks.isEmpty())
+        {
+            if(stopping)
+                break;
+            hasTask.wait(&mutex);
+            continue;
+        }
+
+        {
+            std::function<void()> task = tasks.dequeue();
+            locker.unlock();
+            task(); // the task and what it holds are released before the lock is taken again
+        }
+        locker.relock();
+    }
+}
+
+}
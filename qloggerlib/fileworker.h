@@ -0,0 +1,95 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef FILEWORKER_H
+#define FILEWORKER_H
+
+#include <functional>
+
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace qlogger
+{
+
+//!
+//! \brief The FileWorker class - a thread shared by the file outputs to do the slow file system work, like
+//! opening the next log file or closing a finished one, away from the threads that write the logs.
+//!
+class FileWorker final : public QThread
+{
+public:
+    //!
+    //! \brief acquire - returns the running worker, creating it if no output holds it
+    //! \return the worker, it stops when the last holder releases it
+    //!
+    static QSharedPointer<FileWorker> acquire();
+
+    //! runs every pending task and stops the thread
+    ~FileWorker();
+
+    //! forbid copying
+    FileWorker(const FileWorker &) = delete;
+    FileWorker& operator=(const FileWorker&) = delete;
+
+    //!
+    //! \brief post - queues a task to be run on the worker thread, tasks run in the order they were posted
+    //! \param task
+    //!
+    void post(std::function<void()> task);
+
+protected:
+    //!
+    //! \brief run - the worker loop, runs the tasks and sleeps when there is none
+    //!
+    void run() override;
+
+private:
+    FileWorker();
+
+private:
+    //!
+    //! \brief mutex - guards the task queue
+    //!
+    QMutex mutex;
+
+    //!
+    //! \brief hasTask - signaled when a task is posted or the worker must stop
+    //!
+    QWaitCondition hasTask;
+
+    //!
+    //! \brief tasks - the tasks waiting to run
+    //!
+    QQueue<std::function<void()>> tasks;
+
+    //!
+    //! \brief stopping - true when the worker was asked to stop
+    //!
+    bool stopping;
+};
+
+}
+
+#endif // FILEWORKER_H
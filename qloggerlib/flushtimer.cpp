@@ -0,0 +1,60 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "flushtimer.h"
+
+#include "qlogger.h"
+
+namespace qlogger
+{
+
+FlushTimer::FlushTimer() : stopping(false)
+{
+}
+
+FlushTimer::~FlushTimer()
+{
+    {
+        QMutexLocker locker(&mutex);
+        stopping = true;
+        stopped.wakeOne();
+    }
+    wait();
+}
+
+void FlushTimer::run()
+{
+    QMutexLocker locker(&mutex);
+    while(!stopping)
+    {
+        stopped.wait(&mutex, FLUSH_TIMER_TICK_MS);
+        if(stopping)
+            break;
+
+        locker.unlock();
+        if(!QLogger::isAsynchronous())
+            QLogger::flushDue(currentTimestamp());
+        locker.relock();
+    }
+}
+
+}
@@ -0,0 +1,74 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef FLUSHTIMER_H
+#define FLUSHTIMER_H
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+namespace qlogger
+{
+
+//!
+//! \brief The FlushTimer class - a thread that flushes the outputs whose logs waited longer than their flush
+//! interval on synchronous mode, where an output that goes quiet has no next log to do it. On asynchronous mode
+//! the backend does it when it is idle and the timer does nothing.
+//!
+class FlushTimer final : public QThread
+{
+public:
+    FlushTimer();
+
+    //! stops the thread
+    ~FlushTimer();
+
+    //! forbid copying
+    FlushTimer(const FlushTimer &) = delete;
+    FlushTimer& operator=(const FlushTimer&) = delete;
+
+protected:
+    //!
+    //! \brief run - the timer loop, checks the outputs every FLUSH_TIMER_TICK_MS until it is stopped
+    //!
+    void run() override;
+
+private:
+    //!
+    //! \brief mutex - guards stopping
+    //!
+    QMutex mutex;
+
+    //!
+    //! \brief stopped - signaled when the timer must stop
+    //!
+    QWaitCondition stopped;
+
+    //!
+    //! \brief stopping - true when the timer was asked to stop
+    //!
+    bool stopping;
+};
+
+}
+
+#endif // FLUSHTIMER_H
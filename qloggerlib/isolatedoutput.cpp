@@ -0,0 +1,71 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "isolatedoutput.h"
+
+namespace qlogger
+{
+
+IsolatedOutput::IsolatedOutput(Output *output, int capacity) : Output(output->getConfiguration()),
+    output(output), writer(capacity, output), dropped(0)
+{
+    writer.startBackend();
+}
+
+IsolatedOutput::~IsolatedOutput()
+{
+    writer.stop();
+    writer.drain();
+}
+
+void IsolatedOutput::write(const LogRecord &record)
+{
+    // the texts shared by the other outputs belong to the thread that dispatched the record
+    LogRecord copy(record);
+    copy.rendered = nullptr;
+    if(!writer.tryPush(copy))
+        dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void IsolatedOutput::close()
+{
+    writer.stop();
+    writer.drain();
+    output->close();
+}
+
+void IsolatedOutput::flush()
+{
+    writer.flushOutput();
+}
+
+Output *IsolatedOutput::getOutput() const
+{
+    return output.data();
+}
+
+quint64 IsolatedOutput::getDroppedCount() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef ISOLATEDOUTPUT_H
+#define ISOLATEDOUTPUT_H
+
+#include <atomic>
+
+#include <QScopedPointer>
+
+#include "output.h"
+#include "asyncbackend.h"
+
+namespace qlogger
+{
+
+//!
+//! \brief The IsolatedOutput class - runs another output on a writer thread of its own. Writing a log only puts
+//! a copy of it on a bounded queue, so an output stuck on a slow io (a network drive, a blocked pipe) never holds
+//! qlogger or the other outputs. When the queue is full the log is dropped and counted, the logging thread
+//! never waits for this output. qlogger creates it for configurations with an isolated queue capacity.
+//!
+class IsolatedOutput final : public Output
+{
+public:
+    //!
+    //! \brief IsolatedOutput - takes the output and starts its writer thread
+    //! \param output - the output to be isolated, owned by this class, it shares its configuration
+    //! \param capacity - the max number of logs waiting to be written
+    //!
+    IsolatedOutput(Output *output, int capacity);
+    IsolatedOutput() = delete;
+    //! stops the writer thread after the queued logs were written and deletes the output
+    ~IsolatedOutput();
+
+    //!
+    //! \brief write - queues a copy of the log for the writer thread, dropping it if the queue is full
+    //! \param record
+    //!
+    void write(const LogRecord &record) override;
+
+    //! stops the writer thread after the queued logs were written and closes the output
+    void close() override;
+
+    //! waits until the queued logs were written and flushes the output
+    void flush() override;
+
+    //!
+    //! \brief getOutput - the isolated output, it must only be used on the writer thread or with its mutex locked
+    //!
+    Output* getOutput() const;
+
+    //!
+    //! \brief getDroppedCount - the number of logs dropped because the queue was full
+    //!
+    quint64 getDroppedCount() const;
+
+private:
+    //!
+    //! \brief output - the isolated output, deleted after the writer stopped
+    //!
+    QScopedPointer<Output> output;
+
+    //!
+    //! \brief writer - the queue and thread that write to the output
+    //!
+    AsyncBackend writer;
+
+    //!
+    //! \brief dropped - logs that found the queue full
+    //!
+    std::atomic<quint64> dropped;
+};
+
+}
+
+#endif // ISOLATEDOUTPUT_H
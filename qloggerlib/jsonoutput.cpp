@@ -20,15 +20,20 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #include "jsonoutput.h"
+#include "logger.h"
+#include "textescape.h"
+#include "utf8.h"
 
 #include <QDateTime>
+#include <QStringBuilder>
 
 namespace qlogger
 {
 
 JSONOutput::JSONOutput(Configuration *cfg) : PlainTextOutput (cfg)
 {
-    this->configuration->setFileNameMask(JSON_FILE_NAME_MASK);
+    this->configuration->setFileNameMask(configuration->getJsonFormat() == JSON_LINES ? JSON_LINES_FILE_NAME_MASK
+                                                                                       : JSON_FILE_NAME_MASK);
 }
 
 JSONOutput::~JSONOutput()
@@ -36,46 +41,51 @@ JSONOutput::~JSONOutput()
     if(!outputFile.isNull() && outputFile->isOpen())
     {
         // end current json file.
-        *outputStream << endl << JSON_FILE_END << endl;
+        writeBytes(fileEnd());
     }
     PlainTextOutput::close();
 }
 
-void JSONOutput::write(const QString message, const QString owner,
-                       const Level lvl, const QDateTime timestamp,
-                       const QString functionName, const int lineNumber)
+void JSONOutput::formatEntry(QByteArray &buffer, const LogRecord &record)
 {
-    if(!outputFile.isNull()
-            && outputFile->isOpen()
-            && (outputFile->size() > configuration->getFileMaxSizeInBytes()))
-    {
-        // end current json file.
-        *outputStream << endl << JSON_FILE_END << endl;
-    }
+    // the keys are ASCII, already UTF-8
+    buffer += "{\"owner\":";
+    appendJsonUtf8(buffer, record.logger->getOwnerUtf8());
+    buffer += ",\"level\":\"";
+    buffer += levelToUtf8(record.level);
+    buffer += "\",\"message\":";
+    appendJsonString(buffer, record.message);
+    buffer += ",\"dateTime\":";
+    appendJsonUtf8(buffer, configuration->getTimestampFormatter().formatUtf8(record.timestamp));
+    buffer += ",\"function\":";
+    appendJsonString(buffer, record.functionName);
+    buffer += ",\"line\":";
+    appendNumber(buffer, record.lineNumber);
+    buffer += '}';
 
-    if(outputFile.isNull() //if there is no file
-            || !outputFile->isOpen() // or the file is not opened for writing
-            || (outputFile->size() > configuration->getFileMaxSizeInBytes())) // or the file is already at max size
-    {
-        createNextFile(); // create a new file
+    // every line is a whole json log, nothing to start or end a file
+    if(configuration->getJsonFormat() == JSON_LINES)
+        buffer += '\n';
+}
 
-        // start the xml file.
-        *outputStream << JSON_FILE_START << endl;
-        // the first line will start without adding the comma
-        QString lineNumberStr = QString("%1").arg(lineNumber);
-        *outputStream << JSON_LOG_ENTRY.arg(owner, levelToString(lvl),
-                                            message, timestamp.toString(configuration->getTimestampFormat()),
-                                            functionName, lineNumberStr);
-    }
-    else // continues the file normally
-    {
-        // adds a comma and jump to the next line, in the end of the file there will be no comma
-        *outputStream << "," << endl;
-        QString lineNumberStr = QString("%1").arg(lineNumber);
-        *outputStream << JSON_LOG_ENTRY.arg(owner, levelToString(lvl),
-                                            message, timestamp.toString(configuration->getTimestampFormat()),
-                                            functionName, lineNumberStr);
-    }
+const QByteArray &JSONOutput::fileStart() const
+{
+    // the first line will start without adding the comma
+    static const QByteArray start = (JSON_FILE_START % QLatin1Char('\n')).toUtf8();
+    return configuration->getJsonFormat() == JSON_LINES ? PlainTextOutput::fileStart() : start;
+}
+
+const QByteArray &JSONOutput::entrySeparator() const
+{
+    // adds a comma and jump to the next line, in the end of the file there will be no comma
+    static const QByteArray separator(",\n");
+    return configuration->getJsonFormat() == JSON_LINES ? PlainTextOutput::entrySeparator() : separator;
+}
+
+const QByteArray &JSONOutput::fileEnd() const
+{
+    static const QByteArray end = (QLatin1Char('\n') % JSON_FILE_END % QLatin1Char('\n')).toUtf8();
+    return configuration->getJsonFormat() == JSON_LINES ? PlainTextOutput::fileEnd() : end;
 }
 
 }
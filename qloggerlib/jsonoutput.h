@@ -27,7 +27,8 @@
 namespace qlogger {
 
 //!
-//! \brief The JSONOutput class - saves a text file with a standard json format with the log information
+//! \brief The JSONOutput class - saves a text file with a standard json format with the log information,
+//! a json document per file or, with the JSON_LINES format, one json log per line (NDJSON)
 //!
 class JSONOutput : public PlainTextOutput
 {
@@ -42,20 +43,24 @@ public:
     //!
     ~JSONOutput();
 
-    // Output interface
-public:
+protected:
     //!
-    //! \brief write
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \brief formatEntry - reimplemented to format the log as a json object, followed by a line break on the
+    //! JSON_LINES format
+    //! \param buffer
+    //! \param record
     //!
-    void write(const QString message, const QString owner,
-               const Level lvl, const QDateTime timestamp,
-               const QString functionName, const int lineNumber);
+    void formatEntry(QByteArray &buffer, const LogRecord &record);
+
+    //! the start of the logs array, nothing on the JSON_LINES format
+    const QByteArray &fileStart() const;
+
+    //! the comma between two logs, nothing on the JSON_LINES format
+    const QByteArray &entrySeparator() const;
+
+    //! the end of the logs array, nothing on the JSON_LINES format
+    const QByteArray &fileEnd() const;
+
 };
 
 }
@@ -0,0 +1,86 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "logarguments.h"
+
+namespace qlogger
+{
+
+//! converts a captured argument to text, following what QString::arg does for the same type
+static void appendArgument(QString &text, const QVariant &argument)
+{
+    switch(static_cast<int>(argument.type()))
+    {
+        case QVariant::String:
+            text += *static_cast<const QString*>(argument.constData());
+            break;
+        case QVariant::LongLong:
+            text += QString::number(argument.toLongLong());
+            break;
+        case QVariant::ULongLong:
+            text += QString::number(argument.toULongLong());
+            break;
+        case QVariant::Double:
+            text += QString::number(argument.toDouble());
+            break;
+        case QVariant::ByteArray:
+            text += QString::fromUtf8(*static_cast<const QByteArray*>(argument.constData()));
+            break;
+        default:
+            text += argument.toString();
+            break;
+    }
+}
+
+QString formatLogArguments(const char *format, const LogArguments &arguments)
+{
+    const QString pattern = QString::fromUtf8(format);
+    QString text;
+    text.reserve(pattern.size() + arguments.size() * 8);
+
+    const QChar *begin = pattern.constData();
+    const QChar *end = begin + pattern.size();
+    const QChar *literal = begin;
+    for(const QChar *c = begin ; c != end ; ++c)
+    {
+        if(*c != QLatin1Char('%') || c + 1 == end || !c[1].isDigit())
+            continue;
+
+        // read up to two digits, as QString::arg does
+        const QChar *digits = c + 1;
+        int index = digits->digitValue();
+        if(digits + 1 != end && digits[1].isDigit())
+            index = index * 10 + (++digits)->digitValue();
+
+        if(index < 1 || index > arguments.size())
+            continue;
+
+        text.append(literal, static_cast<int>(c - literal));
+        appendArgument(text, arguments.at(index - 1));
+        c = digits;
+        literal = c + 1;
+    }
+    text.append(literal, static_cast<int>(end - literal));
+    return text;
+}
+
+}
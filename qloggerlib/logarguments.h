@@ -0,0 +1,94 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LOGARGUMENTS_H
+#define LOGARGUMENTS_H
+
+#include <type_traits>
+
+#include <QByteArray>
+#include <QString>
+#include <QVariant>
+#include <QVarLengthArray>
+
+namespace qlogger
+{
+
+//! the arguments captured by a deferred log, up to four are kept inside the record itself
+typedef QVarLengthArray<QVariant, 4> LogArguments;
+
+//! booleans are printed as true / false
+inline QVariant toLogArgument(bool value)
+{
+    return QVariant(value);
+}
+
+//! a char is printed as a character, not as a number
+inline QVariant toLogArgument(char value)
+{
+    return QVariant(QChar(QLatin1Char(value)));
+}
+
+//! signed integers of any size (and enums) are kept as a long long
+template <typename T>
+inline typename std::enable_if<(std::is_integral<T>::value && std::is_signed<T>::value) || std::is_enum<T>::value, QVariant>::type
+toLogArgument(T value)
+{
+    return QVariant(static_cast<qlonglong>(value));
+}
+
+//! unsigned integers of any size are kept as an unsigned long long
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, QVariant>::type
+toLogArgument(T value)
+{
+    return QVariant(static_cast<qulonglong>(value));
+}
+
+//! float and double are kept as a double
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, QVariant>::type
+toLogArgument(T value)
+{
+    return QVariant(static_cast<double>(value));
+}
+
+//! anything else QVariant can hold (QString, QByteArray, QChar, QDateTime...) is copied as is,
+//! implicitly shared Qt types only take a reference here
+template <typename T>
+inline typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value, QVariant>::type
+toLogArgument(const T &value)
+{
+    return QVariant(value);
+}
+
+//!
+//! \brief formatLogArguments - replaces the %1 ... %99 markers of the format with the arguments in a
+//! single pass, markers with no matching argument are kept as they are
+//! \param format - the UTF-8 format string
+//! \param arguments - the captured arguments
+//! \return the formatted message
+//!
+QString formatLogArguments(const char *format, const LogArguments &arguments);
+
+}
+
+#endif // LOGARGUMENTS_H
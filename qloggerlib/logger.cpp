@@ -0,0 +1,188 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "logger.h"
+
+#include "output.h"
+#include "qlogger.h"
+
+namespace qlogger
+{
+
+Logger::Logger(QString owner) : owner(std::move(owner)), ownerUtf8(this->owner.toUtf8()), level(NO_LEVEL),
+    outputs(nullptr)
+{
+}
+
+Logger::~Logger()
+{
+    delete outputs.load();
+}
+
+const QString &Logger::getOwner() const
+{
+    return owner;
+}
+
+const QByteArray &Logger::getOwnerUtf8() const
+{
+    return ownerUtf8;
+}
+
+bool Logger::isOwner(const char *name) const
+{
+    return owner == QLatin1String(name);
+}
+
+bool Logger::isOwner(const QString &name) const
+{
+    return owner == name;
+}
+
+void Logger::enableLevel(Level lvl)
+{
+    int current = level.load(std::memory_order_relaxed);
+    while(current < static_cast<int>(lvl)
+          && !level.compare_exchange_weak(current, static_cast<int>(lvl), std::memory_order_relaxed))
+    {
+    }
+}
+
+void Logger::log(Level lvl, const QString &message, const QString &functionName, int lineNumber) const
+{
+    if(!isEnabled(lvl))
+        return;
+
+    LogRecord record;
+    record.message = message;
+    submit(record, lvl, functionName, lineNumber);
+}
+
+void Logger::log(const CallSite &site, const QString &message) const
+{
+    if(!isEnabled(site.level))
+        return;
+
+    LogRecord record;
+    record.message = message;
+    submit(record, site);
+}
+
+void Logger::submit(LogRecord &record, const CallSite &site) const
+{
+    record.level = site.level;
+    record.timestamp = currentTimestamp();
+    record.logger = this;
+    record.site = &site;
+    QLogger::submit(record);
+}
+
+void Logger::submit(LogRecord &record, Level lvl, const QString &functionName, int lineNumber) const
+{
+    record.level = lvl;
+    record.timestamp = currentTimestamp();
+    record.logger = this;
+    record.functionName = functionName;
+    record.lineNumber = lineNumber;
+    QLogger::submit(record);
+}
+
+void Logger::fatal(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q0FATAL, message, functionName, lineNumber);
+}
+
+void Logger::error(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q1ERROR, message, functionName, lineNumber);
+}
+
+void Logger::warn(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q2WARN, message, functionName, lineNumber);
+}
+
+void Logger::info(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q3INFO, message, functionName, lineNumber);
+}
+
+void Logger::debug(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q4DEBUG, message, functionName, lineNumber);
+}
+
+void Logger::trace(const QString &message, const QString &functionName, int lineNumber) const
+{
+    log(q5TRACE, message, functionName, lineNumber);
+}
+
+const OutputList *Logger::getOutputs() const
+{
+    return outputs.load(std::memory_order_acquire);
+}
+
+void Logger::addOutput(const QSharedPointer<Output> &output, Level lvl)
+{
+    const OutputList *current = outputs.load(std::memory_order_relaxed);
+    OutputList *next = current != nullptr ? new OutputList(*current) : new OutputList();
+    next->append(output);
+    outputs.store(next, std::memory_order_release);
+    // readers take no lock, one of them may still be going through the old list
+    if(current != nullptr)
+        QLogger::retire(current);
+    enableLevel(lvl);
+}
+
+void Logger::replaceOutput(const QSharedPointer<Output> &old, const QSharedPointer<Output> &output)
+{
+    const OutputList *current = outputs.load(std::memory_order_relaxed);
+    if(current == nullptr)
+        return;
+    OutputList *next = new OutputList();
+    next->reserve(current->size());
+    for(const QSharedPointer<Output> &out : *current)
+    {
+        if(out != old)
+            next->append(out);
+        else if(!output.isNull())
+            next->append(output);
+    }
+    outputs.store(next, std::memory_order_release);
+    // the old output is deleted with the last list holding it, after the threads writing to it are done
+    QLogger::retire(current);
+    updateLevel();
+}
+
+void Logger::updateLevel()
+{
+    int enabled = NO_LEVEL;
+    const OutputList *current = outputs.load(std::memory_order_relaxed);
+    if(current != nullptr)
+    {
+        for(const QSharedPointer<Output> &out : *current)
+            enabled = qMax(enabled, static_cast<int>(out->getConfiguration()->getLogLevel()));
+    }
+    level.store(enabled, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,237 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "qloggerlib_global.h"
+#include "logrecord.h"
+
+namespace qlogger
+{
+
+class Output;
+
+//! the outputs of an owner, once published a list is never changed, a new one replaces it
+typedef QVector<QSharedPointer<Output>> OutputList;
+
+//!
+//! \brief The Logger class - the runtime state qlogger keeps for each log owner. It is created the first
+//! time an owner is referenced and lives as long as qlogger, so its address can be cached by the callers.
+//! It is also the handle returned by QLogger::getLogger, logging through it skips the owner lookup.
+//!
+class Logger final
+{
+public:
+    //!
+    //! \brief Logger - creates an owner entry with no level enabled
+    //! \param owner - the name of the log owner
+    //!
+    explicit Logger(QString owner);
+    Logger() = delete;
+    //! releases the output list
+    ~Logger();
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    //!
+    //! \brief getOwner - the name of the log owner
+    //!
+    const QString& getOwner() const;
+
+    //!
+    //! \brief getOwnerUtf8 - the name of the log owner encoded once as UTF-8
+    //!
+    const QByteArray& getOwnerUtf8() const;
+
+    //!
+    //! \brief isEnabled - tells if at least one output of this owner accepts the level, this is a single
+    //! relaxed atomic load so it is checked before any log work is done
+    //! \param lvl - the level to be checked
+    //!
+    inline bool isEnabled(Level lvl) const
+    {
+        return static_cast<int>(lvl) <= level.load(std::memory_order_relaxed);
+    }
+
+    //!
+    //! \brief isOwner - compares the owner name without creating a QString, only latin1 names match here
+    //! \param name - the owner name to compare
+    //!
+    bool isOwner(const char *name) const;
+
+    //!
+    //! \brief isOwner - compares the owner name
+    //! \param name - the owner name to compare
+    //!
+    bool isOwner(const QString &name) const;
+
+    //!
+    //! \brief enableLevel - widens the cached level so it includes lvl, called when an output is added
+    //! \param lvl - the level of the added output
+    //!
+    void enableLevel(Level lvl);
+
+    //!
+    //! \brief log - logs a message on this owner outputs
+    //! \param lvl - the level of the message
+    //! \param message - the actual log message to be, er.. logged
+    //! \param functionName - the function (if any) where this log was called
+    //! \param lineNumber - the line number were this log was called
+    //!
+    void log(Level lvl, const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //!
+    //! \brief log - logs a message made on a call site, the record only takes a pointer to the site
+    //! \param site - the static descriptor of the call, with its level
+    //! \param message - the actual log message
+    //!
+    void log(const CallSite &site, const QString &message) const;
+
+    //!
+    //! \brief logFormat - logs a message built from a format and its arguments, only the format pointer and a
+    //! copy of the arguments are taken here, the text is built by the thread that writes the log
+    //! \param lvl - the level of the message
+    //! \param functionName - the function (if any) where this log was called
+    //! \param lineNumber - the line number were this log was called
+    //! \param format - a string literal with the %1, %2... markers, as QString::arg uses
+    //! \param arguments - ints, doubles, enums, QString, QByteArray or anything QVariant holds
+    //!
+    template <size_t N, typename... Args>
+    void logFormat(Level lvl, const QString &functionName, int lineNumber,
+                   const char (&format)[N], const Args &...arguments) const
+    {
+        if(!isEnabled(lvl))
+            return;
+
+        LogRecord record;
+        record.format = format;
+        record.arguments.reserve(static_cast<int>(sizeof...(Args)));
+        int expand[] = { 0, (record.arguments.append(toLogArgument(arguments)), 0)... };
+        Q_UNUSED(expand);
+        submit(record, lvl, functionName, lineNumber);
+    }
+
+    //!
+    //! \brief logFormat - same as above for a log made on a call site, the record only takes a pointer to the site
+    //! \param site - the static descriptor of the call, with its level
+    //! \param format - a string literal with the %1, %2... markers, as QString::arg uses
+    //! \param arguments - ints, doubles, enums, QString, QByteArray or anything QVariant holds
+    //!
+    template <size_t N, typename... Args>
+    void logFormat(const CallSite &site, const char (&format)[N], const Args &...arguments) const
+    {
+        if(!isEnabled(site.level))
+            return;
+
+        LogRecord record;
+        record.format = format;
+        record.arguments.reserve(static_cast<int>(sizeof...(Args)));
+        int expand[] = { 0, (record.arguments.append(toLogArgument(arguments)), 0)... };
+        Q_UNUSED(expand);
+        submit(record, site);
+    }
+
+    //! logs directly to fatal level
+    void fatal(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //! logs directly to error level
+    void error(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //! logs directly to warn level
+    void warn(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //! logs directly to info level
+    void info(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //! logs directly to debug level
+    void debug(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //! logs directly to trace level
+    void trace(const QString &message, const QString &functionName = QString(), int lineNumber = -1) const;
+
+    //!
+    //! \brief getOutputs - the current output list of this owner, nullptr if there is none yet, it takes
+    //! no lock, the list must be used inside a SnapshotReader
+    //!
+    const OutputList* getOutputs() const;
+
+    //!
+    //! \brief addOutput - publishes a new list with the output appended and widens the level,
+    //! must be called with the qlogger registry mutex locked
+    //! \param output - the output to be added
+    //! \param lvl - the level of the output
+    //!
+    void addOutput(const QSharedPointer<Output> &output, Level lvl);
+
+    //!
+    //! \brief replaceOutput - publishes a new list with an output replaced by another one, or removed, and
+    //! recomputes the level, must be called with the qlogger registry mutex locked
+    //! \param old - the output to be replaced
+    //! \param output - the output taking its place, a null pointer removes the old one
+    //!
+    void replaceOutput(const QSharedPointer<Output> &old, const QSharedPointer<Output> &output);
+
+    //!
+    //! \brief updateLevel - recomputes the cached level from the levels of the outputs, called when the level
+    //! of an output changed, must be called with the qlogger registry mutex locked
+    //!
+    void updateLevel();
+
+private:
+    //! fills the common record fields and sends it to be written
+    void submit(LogRecord &record, Level lvl, const QString &functionName, int lineNumber) const;
+
+    //! fills the common record fields from the call site and sends it to be written
+    void submit(LogRecord &record, const CallSite &site) const;
+
+private:
+    //!
+    //! \brief owner - the name of the log owner
+    //!
+    const QString owner;
+
+    //!
+    //! \brief ownerUtf8 - the owner name encoded as UTF-8, for the outputs that write bytes
+    //!
+    const QByteArray ownerUtf8;
+
+    //!
+    //! \brief level - the most verbose level enabled on any output of this owner, NO_LEVEL when there is none
+    //!
+    std::atomic<int> level;
+
+    //!
+    //! \brief outputs - the outputs of this owner, replaced as a whole when an output is added
+    //!
+    std::atomic<const OutputList*> outputs;
+};
+
+}
+
+#endif // LOGGER_H
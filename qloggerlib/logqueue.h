@@ -0,0 +1,170 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LOGQUEUE_H
+#define LOGQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include <QScopedArrayPointer>
+
+namespace qlogger
+{
+
+//!
+//! \brief The LogQueue class - a bounded lock-free queue that accepts many producers, used to hand
+//! log records from the logging threads to the asynchronous backend. It is based on the bounded
+//! queue design by Dmitry Vyukov, each cell carries a sequence number that tells producers and
+//! the consumer if the cell is free or filled, so no thread ever waits on a lock.
+//!
+template <typename T>
+class LogQueue final
+{
+public:
+    //!
+    //! \brief LogQueue - creates the queue, the capacity is rounded up to the next power of two
+    //! \param capacity - the max number of elements the queue can hold
+    //!
+    explicit LogQueue(size_t capacity) : mask(roundUp(capacity) - 1), cells(new Cell[mask + 1])
+    {
+        for(size_t i = 0 ; i <= mask ; i++)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        enqueuePos.store(0, std::memory_order_relaxed);
+        dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    ~LogQueue() = default;
+    LogQueue(const LogQueue&) = delete;
+    LogQueue& operator=(const LogQueue&) = delete;
+
+    //!
+    //! \brief tryPush - moves the element into the queue
+    //! \param value - the element, it is only moved from when the push succeeds
+    //! \return false if the queue is full
+    //!
+    bool tryPush(T &value)
+    {
+        Cell *cell;
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if(diff == 0)
+            {
+                if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                return false; // full
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //!
+    //! \brief tryPop - moves the oldest element out of the queue
+    //! \param value - receives the element
+    //! \return false if the queue is empty
+    //!
+    bool tryPop(T &value)
+    {
+        Cell *cell;
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            cell = &cells[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if(diff == 0)
+            {
+                if(dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+            {
+                return false; // empty
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+        value = std::move(cell->data);
+        cell->data = T(); // release any resource still held by the cell
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    //!
+    //! \brief isEmpty - true if there is no element ready to be popped
+    //!
+    bool isEmpty() const
+    {
+        size_t pos = dequeuePos.load(std::memory_order_seq_cst);
+        size_t seq = cells[pos & mask].sequence.load(std::memory_order_seq_cst);
+        return static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0;
+    }
+
+    //!
+    //! \brief capacity - the max number of elements this queue holds
+    //!
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+private:
+    //! round the capacity to a power of two so the position can be masked instead of divided
+    static size_t roundUp(size_t value)
+    {
+        size_t result = 2;
+        while(result < value)
+            result <<= 1;
+        return result;
+    }
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    //! positions are kept on their own cache lines so producers and consumer do not share them
+    alignas(64) const size_t mask;
+    QScopedArrayPointer<Cell> cells;
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+};
+
+}
+
+#endif // LOGQUEUE_H
@@ -0,0 +1,102 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LOGRECORD_H
+#define LOGRECORD_H
+
+#include <QString>
+
+#include "qloggerlib_global.h"
+#include "callsite.h"
+#include "logarguments.h"
+
+namespace qlogger
+{
+
+class Logger;
+class RenderCache;
+
+//!
+//! \brief The LogRecord struct - a single captured log call, this is what travels from the
+//! logging thread to the outputs when qlogger is working on asynchronous mode
+//!
+struct LogRecord
+{
+    //! the level this record was logged with
+    Level level = q1ERROR;
+
+    //! the moment the log call was made, nanoseconds since epoch
+    qint64 timestamp = 0;
+
+    //! the owner entry of this record
+    const Logger *logger = nullptr;
+
+    //! the call site of a macro log, nullptr for logs made without the macros
+    const CallSite *site = nullptr;
+
+    //! the function (if any) where the log was called, filled from the site by resolve
+    QString functionName;
+
+    //! the line number where the log was called, filled from the site by resolve
+    int lineNumber = -1;
+
+    //! the actual log message, empty when the message is formatted later from format and arguments
+    QString message;
+
+    //! the static format string of a deferred log, nullptr when message is already the final text
+    const char *format = nullptr;
+
+    //! the arguments of a deferred log
+    LogArguments arguments;
+
+    //! the texts shared by the outputs of the owner while the record is written, nullptr when there is nobody to share with
+    RenderCache *rendered = nullptr;
+
+    //!
+    //! \brief text - the final message text, formats a deferred log on the thread that writes it
+    //!
+    inline QString text() const
+    {
+        return format == nullptr ? message : formatLogArguments(format, arguments);
+    }
+
+    //!
+    //! \brief resolve - formats a deferred log into message and takes the function and line from the call site,
+    //! the outputs only read message, functionName and lineNumber
+    //!
+    inline void resolve()
+    {
+        if(site != nullptr)
+        {
+            functionName = site->functionName();
+            lineNumber = site->line;
+        }
+
+        if(format == nullptr)
+            return;
+        message = formatLogArguments(format, arguments);
+        format = nullptr;
+    }
+};
+
+}
+
+#endif // LOGRECORD_H
@@ -0,0 +1,142 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "logtextmask.h"
+
+#include "utf8.h"
+
+namespace qlogger
+{
+
+void appendNumber(QString &buffer, int value)
+{
+    char digits[12];
+    int pos = sizeof(digits);
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    do
+    {
+        digits[--pos] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    while(magnitude != 0);
+    if(value < 0)
+        digits[--pos] = '-';
+    buffer += QLatin1String(digits + pos, static_cast<int>(sizeof(digits)) - pos);
+}
+
+LogTextMask::LogTextMask(const QString &mask) : literalSize(0), timestampUsed(false)
+{
+    QString literal;
+    for(int i = 0 ; i < mask.size() ; i++)
+    {
+        Field field = LITERAL;
+        if(mask.at(i) == QLatin1Char('%') && i + 1 < mask.size())
+        {
+            switch(mask.at(i + 1).unicode())
+            {
+                case 't': field = TIMESTAMP; break;
+                case 'm': field = MESSAGE; break;
+                case 'l': field = LEVEL; break;
+                case 'o': field = OWNER; break;
+                case 'f': field = FUNCTION; break;
+                case 'n': field = LINE; break;
+                default: break;
+            }
+        }
+
+        if(field == LITERAL)
+        {
+            literal += mask.at(i);
+            continue;
+        }
+
+        if(!literal.isEmpty())
+        {
+            tokens.append({LITERAL, literal, literal.toUtf8()});
+            literalSize += literal.size();
+            literal.clear();
+        }
+        tokens.append({field, QString(), QByteArray()});
+        timestampUsed = timestampUsed || field == TIMESTAMP;
+        i++; // skip the symbol letter
+    }
+
+    if(!literal.isEmpty())
+    {
+        tokens.append({LITERAL, literal, literal.toUtf8()});
+        literalSize += literal.size();
+    }
+}
+
+void LogTextMask::format(QString &buffer,
+                         const QString &message,
+                         const QString &owner,
+                         const QString &lvl,
+                         const QString &timestamp,
+                         const QString &functionName,
+                         const int lineNumber) const
+{
+    buffer.reserve(buffer.size() + literalSize + message.size() + timestamp.size() + owner.size() + functionName.size() + 16);
+    for(const Token &token : tokens)
+    {
+        switch(token.field)
+        {
+            case LITERAL: buffer += token.literal; break;
+            case TIMESTAMP: buffer += timestamp; break;
+            case MESSAGE: buffer += message; break;
+            case LEVEL: buffer += lvl; break;
+            case OWNER: buffer += owner; break;
+            case FUNCTION: buffer += functionName; break;
+            case LINE: appendNumber(buffer, lineNumber); break;
+        }
+    }
+}
+
+void LogTextMask::format(QByteArray &buffer,
+                         const QString &message,
+                         const QByteArray &owner,
+                         const QByteArray &lvl,
+                         const QByteArray &timestamp,
+                         const QString &functionName,
+                         const int lineNumber) const
+{
+    for(const Token &token : tokens)
+    {
+        switch(token.field)
+        {
+            case LITERAL: buffer += token.literalUtf8; break;
+            case TIMESTAMP: buffer += timestamp; break;
+            case MESSAGE: appendUtf8(buffer, message); break;
+            case LEVEL: buffer += lvl; break;
+            case OWNER: buffer += owner; break;
+            case FUNCTION: appendUtf8(buffer, functionName); break;
+            case LINE: appendNumber(buffer, lineNumber); break;
+        }
+    }
+}
+
+bool LogTextMask::usesTimestamp() const
+{
+    return timestampUsed;
+}
+
+}
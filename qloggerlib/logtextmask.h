@@ -0,0 +1,118 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef LOGTEXTMASK_H
+#define LOGTEXTMASK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+namespace qlogger
+{
+
+//! appends the decimal number without creating a temporary string
+void appendNumber(QString &buffer, int value);
+
+//!
+//! \brief The LogTextMask class - a log text mask compiled once into a list of literal runs and fields,
+//! so a log text is built with a single append pass instead of one search and replace per symbol.
+//! The symbols are: %t timestamp, %m message, %l level, %o owner, %f function and %n line number.
+//!
+class LogTextMask final
+{
+public:
+    //!
+    //! \brief LogTextMask - compiles the mask
+    //! \param mask - the log text mask
+    //!
+    explicit LogTextMask(const QString &mask = QString());
+    ~LogTextMask() = default;
+
+    //!
+    //! \brief format - appends the log text to buffer, the message is never scanned for symbols
+    //! \param buffer - where the text is appended
+    //! \param message - the log message
+    //! \param owner - the log owner
+    //! \param lvl - the level name
+    //! \param timestamp - the formatted timestamp
+    //! \param functionName - the function name
+    //! \param lineNumber - the line number
+    //!
+    void format(QString &buffer,
+                const QString &message,
+                const QString &owner,
+                const QString &lvl,
+                const QString &timestamp,
+                const QString &functionName,
+                const int lineNumber) const;
+
+    //!
+    //! \brief format - appends the log text encoded as UTF-8, the literal runs of the mask are encoded once
+    //! and the fields that are the same for many logs (owner, level and time) are given already encoded
+    //! \param buffer - where the text is appended
+    //! \param message - the log message
+    //! \param owner - the log owner, UTF-8
+    //! \param lvl - the level name, UTF-8
+    //! \param timestamp - the formatted timestamp, UTF-8
+    //! \param functionName - the function name
+    //! \param lineNumber - the line number
+    //!
+    void format(QByteArray &buffer,
+                const QString &message,
+                const QByteArray &owner,
+                const QByteArray &lvl,
+                const QByteArray &timestamp,
+                const QString &functionName,
+                const int lineNumber) const;
+
+    //!
+    //! \brief usesTimestamp - true if the mask has the %t symbol, outputs skip formatting the time otherwise
+    //!
+    bool usesTimestamp() const;
+
+private:
+    //! what each token of the compiled mask appends
+    enum Field
+    {
+        LITERAL, TIMESTAMP, MESSAGE, LEVEL, OWNER, FUNCTION, LINE
+    };
+
+    struct Token
+    {
+        Field field;
+        QString literal;
+        QByteArray literalUtf8;
+    };
+
+    //! the compiled mask
+    QVector<Token> tokens;
+
+    //! the sum of the literal runs, used to reserve the buffer
+    int literalSize;
+
+    //! true if %t is used
+    bool timestampUsed;
+};
+
+}
+
+#endif // LOGTEXTMASK_H
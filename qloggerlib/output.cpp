@@ -21,14 +21,78 @@
 */
 #include "output.h"
 
+#include "qlogger.h"
+
 namespace qlogger
 {
 
-Output::Output(Configuration* conf) : configuration(QSharedPointer<Configuration>(conf)) {}
+Output::Output(Configuration* conf) : configuration(QSharedPointer<Configuration>(conf)),
+    bufferedByDefault(false), pendingBytes(0), lastFlush(currentTimestamp()) {}
+
+Output::Output(const QSharedPointer<Configuration> &conf) : configuration(conf),
+    bufferedByDefault(false), pendingBytes(0), lastFlush(currentTimestamp()) {}
+
+void Output::writeBatch(const LogRecord *records, int count)
+{
+    for(int i = 0; i < count; ++i)
+    {
+        if(records[i].level <= configuration->getLogLevel())
+            write(records[i]);
+    }
+}
 
 QSharedPointer<Configuration> Output::getConfiguration() const
 {
     return configuration;
 }
 
+QMutex *Output::getMutex()
+{
+    return &outputx;
+}
+
+void Output::flushPending()
+{
+    if(pendingBytes > 0)
+    {
+        flush();
+        pendingBytes = 0;
+    }
+    lastFlush = currentTimestamp();
+}
+
+void Output::flushIfDue(qint64 now)
+{
+    int interval = configuration->getFlushInterval();
+    if(interval == DEFAULT_FLUSH_POLICY)
+        interval = bufferedByDefault ? DEFAULT_FLUSH_INTERVAL_MS : 0;
+
+    if(pendingBytes > 0 && interval > 0 && now - lastFlush >= static_cast<qint64>(interval) * 1000000)
+        flushPending();
+}
+
+void Output::written(Level lvl, qint64 size, qint64 timestamp)
+{
+    pendingBytes += size;
+
+    qint64 bufferSize = configuration->getFlushBufferSize();
+    if(bufferSize == DEFAULT_FLUSH_POLICY)
+        bufferSize = bufferedByDefault ? DEFAULT_FLUSH_BUFFER_SIZE : 0;
+
+    int flushLevel = configuration->getFlushLevel();
+    if(flushLevel == DEFAULT_FLUSH_POLICY)
+        flushLevel = bufferedByDefault ? DEFAULT_FLUSH_LEVEL : q5TRACE;
+
+    if(pendingBytes >= bufferSize || static_cast<int>(lvl) <= flushLevel)
+    {
+        flushPending();
+        return;
+    }
+
+    flushIfDue(timestamp);
+    // on synchronous mode an output that goes quiet has no next log to check the interval, the timer does
+    if(pendingBytes > 0 && !QLogger::isAsynchronous())
+        QLogger::startFlushTimer();
+}
+
 }
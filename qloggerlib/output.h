@@ -22,9 +22,11 @@
 #ifndef OUTPUT_H
 #define OUTPUT_H
 
+#include <QMutex>
 #include <QSharedPointer>
 
 #include "configuration.h"
+#include "logrecord.h"
 
 using namespace std;
 
@@ -41,31 +43,52 @@ public:
 
     //!
     //! \brief write -  implement this method in order to be called to write the log on the io
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \param record - the log, its message already formatted (see LogRecord::resolve) and its time in
+    //! nanoseconds since epoch (see currentTimestamp())
     //!
-    virtual void write(const QString message,
-                       const QString owner,
-                       const Level lvl,
-                       const QDateTime timestamp,
-                       const QString functionName,
-                       const int lineNumber) = 0;
+    virtual void write(const LogRecord &record) = 0;
+
+    //!
+    //! \brief writeBatch - writes many logs at once, the default writes them one by one with write, outputs
+    //! that can hand a batch to the io with fewer calls reimplement it
+    //! \param records - the logs, in order
+    //! \param count - the number of records
+    //!
+    virtual void writeBatch(const LogRecord *records, int count);
 
     //!
     //! \brief close -  implement if any cleanup will be done after all logs were written
     //!
     virtual void close() = 0;
 
+    //!
+    //! \brief flush -  implement to push any buffered log to the io
+    //!
+    virtual void flush() = 0;
+
+    //!
+    //! \brief flushPending - flushes the output if any log was written since the last flush
+    //!
+    void flushPending();
+
+    //!
+    //! \brief flushIfDue - flushes the output if a written log waits longer than the flush interval
+    //! \param now - the current time in nanoseconds since epoch
+    //!
+    void flushIfDue(qint64 now);
+
     //!
     //! \brief getConfiguration - retrives the configuration associated with this output
     //! \return
     //!
     QSharedPointer<Configuration> getConfiguration() const;
 
+    //!
+    //! \brief getMutex - held while the output writes or flushes, so each output is used by one thread at a time
+    //! and threads logging to different outputs do not wait on each other
+    //!
+    QMutex* getMutex();
+
     //!
     //! \brief Output - the standard constructor for an output
     //! \param conf - the obligatory configuration that this output will hold
@@ -83,12 +106,48 @@ public:
     Output(Output&&) = delete;
     Output& operator=(Output&&) = delete;
 
+protected:
+    //!
+    //! \brief Output - an output that shares the configuration of another one
+    //! \param conf - the configuration, already owned by the other output
+    //!
+    explicit Output(const QSharedPointer<Configuration> &conf);
+
+    //!
+    //! \brief written - applies the flush policy after a log was written, call it at the end of write
+    //! \param lvl - the level of the log
+    //! \param size - about how many bytes were written
+    //! \param timestamp - the log time
+    //!
+    void written(Level lvl, qint64 size, qint64 timestamp);
+
 protected:
     //!
     //! \brief configuration - the actual configuration for the log/owner and this output
     //!
     QSharedPointer<Configuration> configuration;
 
+    //!
+    //! \brief bufferedByDefault - true for outputs that buffer unless the configuration says otherwise
+    //!
+    bool bufferedByDefault;
+
+private:
+    //!
+    //! \brief pendingBytes - bytes written since the last flush
+    //!
+    qint64 pendingBytes;
+
+    //!
+    //! \brief lastFlush - the time of the last flush, nanoseconds since epoch
+    //!
+    qint64 lastFlush;
+
+    //!
+    //! \brief outputx - see getMutex
+    //!
+    QMutex outputx;
+
 };
 
 
@@ -23,21 +23,31 @@
 #include "qlogger.h"
 
 #include <QDirIterator>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
 #include <QSettings>
-#include <QRegularExpression>
+#include <QThread>
+#include <QTimer>
 #include <QDateTime>
 
 #include "consoleoutput.h"
 #include "textoutput.h"
 #include "xmloutput.h"
 #include "signaloutput.h"
+#include "isolatedoutput.h"
 #include "jsonoutput.h"
+#include "binaryoutput.h"
+#include "asyncbackend.h"
+#include "flushtimer.h"
+#include "rendercache.h"
 
 namespace qlogger
 {
 
 QMutex QLogger::writex;
 
+QMutex QLogger::registryx;
+
 bool QLogger::instanceFlag = false;
 
 QLogger& QLogger::instance()
@@ -57,13 +67,36 @@ QLogger& QLogger::instance()
     return instance;
 }
 
+QLogger::~QLogger()
+{
+    // the timer reads the registry
+    flushTimer.reset();
+    // writes whatever is still waiting on the queue
+    backend.store(nullptr);
+    asyncBackend.reset();
+    const LoggerRegistry *registry = owners.load();
+    if(registry != nullptr)
+        qDeleteAll(*registry);
+    delete registry;
+    // nothing is logged anymore, the retired snapshots do not wait for readers
+    for(const RetiredSnapshot &old : retired)
+        old.deleter(old.snapshot);
+}
+
+//! the texts shared by the outputs of an owner, one for each record of a batch, each thread has its own
+static QVector<RenderCache> &renderCaches()
+{
+    static thread_local QVector<RenderCache> caches;
+    return caches;
+}
+
 void QLogger::addLogger(Configuration* configuration, Output *output)
 {
     if(configuration != nullptr && output != nullptr)
     {
         if(configuration->validate())
         {
-            instance().loggers.insert(configuration->getLogOwner(), QSharedPointer<Output>(output));
+            publishOutput(configuration, output);
         }
         else //if no logger is created then cleanup memory
         {
@@ -73,20 +106,26 @@ void QLogger::addLogger(Configuration* configuration, Output *output)
     }
 }
 
+QSharedPointer<Output> QLogger::publishOutput(Configuration *configuration, Output *output,
+                                             const QSharedPointer<Output> &replaced)
+{
+    Logger *entry = getLogger(configuration->getLogOwner());
+    if(configuration->isIsolated())
+        output = new IsolatedOutput(output, configuration->getIsolatedQueueCapacity());
+    QSharedPointer<Output> published(output);
+    QMutexLocker locker(&registryx);
+    if(replaced.isNull())
+        entry->addOutput(published, configuration->getLogLevel());
+    else
+        entry->replaceOutput(replaced, published);
+    return published;
+}
+
 void QLogger::addLogger(Configuration* configuration, OutputType type)
 {
     if(configuration != nullptr)
     {
-        QLogger::addLogger(configuration->getLogOwner(),
-                           configuration->getLogLevel(),
-                           type,
-                           configuration->getLogTextMask(),
-                           configuration->getTimestampFormat(),
-                           configuration->getFileNameMask(),
-                           configuration->getFileNameTimestampFormat(),
-                           configuration->getFilePath(),
-                           configuration->getFileMaxSizeInBytes());
-        delete configuration;
+        addLogger(configuration, createOutput(configuration, type));
     }
 }
 
@@ -105,8 +144,13 @@ void QLogger::addLogger(QString logOwner, Level lvl, OutputType ouputType,
                                                      std::move(fileNameMask),
                                                      std::move(fileNameTimestampFormat),
                                                      std::move(filePath), fileMaxSizeInBytes);
+    addLogger(configuration, createOutput(configuration, ouputType));
+}
+
+Output *QLogger::createOutput(Configuration *configuration, OutputType type)
+{
     Output* output = nullptr;
-    switch(ouputType)
+    switch(type)
     {
         case CONSOLE:
             output = new ConsoleOutput(configuration);
@@ -123,23 +167,295 @@ void QLogger::addLogger(QString logOwner, Level lvl, OutputType ouputType,
         case JSON:
             output = new JSONOutput(configuration);
             break;
+        case BINARY:
+            output = new BinaryOutput(configuration);
+            break;
     };
-    addLogger(configuration, output);
+    return output;
 }
 
 void QLogger::log(Level lvl, const QString &message, const QString &functionName, int lineNumber, const QString &owner)
 {
-    writex.lock();
+    Logger *entry = findLogger(owner);
+    if(entry != nullptr)
+        entry->log(lvl, message, functionName, lineNumber);
+}
+
+void QLogger::submit(LogRecord &record)
+{
+    // setAsynchronous(false) waits for the readers, so no record is pushed after the final drain
+    SnapshotReader reader;
+    AsyncBackend *async = instance().backend.load(std::memory_order_acquire);
+    if(async != nullptr)
+    {
+        async->push(record);
+        return;
+    }
+
+    // each output is locked on its own, threads logging to other outputs are not held
+    dispatch(record);
+}
+
+void QLogger::dispatch(LogRecord &record)
+{
+    SnapshotReader reader;
+    const OutputList *outList = record.logger->getOutputs();
+    if(outList == nullptr)
+        return;
+
+    // a deferred log is formatted here, once, on the thread that writes it
+    record.resolve();
+
+    // a single output has nobody to share the formatted text with
+    QVector<RenderCache> &caches = renderCaches();
+    if(outList->size() > 1)
+    {
+        if(caches.isEmpty())
+            caches.resize(1);
+        caches[0].clear();
+        record.rendered = &caches[0];
+    }
+
+    for(const QSharedPointer<Output> &out : *outList)
+    {
+        if(record.level <= out->getConfiguration()->getLogLevel())
+        {
+            QMutexLocker locker(out->getMutex());
+            out->write(record);
+        }
+    }
+    record.rendered = nullptr;
+}
+
+void QLogger::dispatchBatch(LogRecord *records, int count)
+{
+    // a deferred log is formatted here, once for all the outputs
+    for(int i = 0; i < count; ++i)
+        records[i].resolve();
+
+    SnapshotReader reader;
+    QVector<RenderCache> &caches = renderCaches();
+    if(caches.size() < count)
+        caches.resize(count);
+
+    for(int first = 0, last = 0; first < count; first = last)
+    {
+        const OutputList *outList = records[first].logger->getOutputs();
+        for(last = first + 1; last < count && records[last].logger->getOutputs() == outList; ++last) {}
+
+        if(outList == nullptr)
+            continue;
+
+        // each record has its own texts, the outputs go through the whole batch one after the other
+        const bool shared = outList->size() > 1;
+        for(int i = first; i < last; ++i)
+        {
+            if(shared)
+                caches[i].clear();
+            records[i].rendered = shared ? &caches[i] : nullptr;
+        }
+
+        for(const QSharedPointer<Output> &out : *outList)
+        {
+            QMutexLocker locker(out->getMutex());
+            out->writeBatch(records + first, last - first);
+        }
+    }
+
+    for(int i = 0; i < count; ++i)
+        records[i].rendered = nullptr;
+}
+
+void QLogger::setAsynchronous(bool enabled, int queueCapacity)
+{
+    static QMutex modeMutex;
+    QMutexLocker locker(&modeMutex);
+
+    QLogger &logger = instance();
+    if(enabled)
+    {
+        if(logger.asyncBackend.isNull())
+            logger.asyncBackend.reset(new AsyncBackend(queueCapacity));
+        logger.asyncBackend->startBackend();
+        logger.backend.store(logger.asyncBackend.data(), std::memory_order_release);
+    }
+    else if(!logger.asyncBackend.isNull())
+    {
+        logger.backend.store(nullptr, std::memory_order_release);
+        // a logging thread may have taken the backend just before, it pushes while reading (see submit)
+        const quint64 epoch = SnapshotReader::retireEpoch();
+        while(!SnapshotReader::isReclaimable(epoch))
+            QThread::yieldCurrentThread();
+        logger.asyncBackend->stop();
+        logger.asyncBackend->drain();
+    }
+}
+
+bool QLogger::isAsynchronous()
+{
+    return instance().backend.load(std::memory_order_acquire) != nullptr;
+}
+
+void QLogger::flush()
+{
+    QLogger &logger = instance();
+    AsyncBackend *async = logger.backend.load(std::memory_order_acquire);
+    if(async != nullptr)
+        async->waitUntilEmpty();
+
+    {
+        // the backend writes a batch with writex locked, taking it waits for the batch in progress
+        QMutexLocker locker(&writex);
+    }
+    {
+        // a good moment to delete the snapshots that were waiting for their readers
+        QMutexLocker locker(&registryx);
+        reclaim();
+    }
+
+    OutputList isolated;
+    {
+        SnapshotReader reader;
+        const LoggerRegistry *registry = logger.owners.load(std::memory_order_acquire);
+        if(registry != nullptr)
+        {
+            for(Logger *entry : *registry)
+            {
+                const OutputList *outList = entry->getOutputs();
+                if(outList == nullptr)
+                    continue;
+                for(const QSharedPointer<Output> &out : *outList)
+                {
+                    if(dynamic_cast<IsolatedOutput*>(out.data()) != nullptr)
+                    {
+                        isolated.append(out);
+                        continue;
+                    }
+                    QMutexLocker locker(out->getMutex());
+                    out->flushPending();
+                }
+            }
+        }
+    }
+
+    // a slow isolated output is waited for after the others
+    for(const QSharedPointer<Output> &out : isolated)
+        out->flush();
+}
+
+quint64 QLogger::getDroppedCount(const QString &owner)
+{
+    Logger *entry = findLogger(owner);
+    if(entry == nullptr)
+        return 0;
+
+    quint64 dropped = 0;
+    SnapshotReader reader;
+    const OutputList *outList = entry->getOutputs();
+    for(int i = 0 ; outList != nullptr && i < outList->size() ; i++)
+    {
+        auto out = dynamic_cast<IsolatedOutput*>(outList->at(i).data());
+        if(out != nullptr)
+            dropped += out->getDroppedCount();
+    }
+    return dropped;
+}
+
+void QLogger::flushDue(qint64 now)
+{
+    SnapshotReader reader;
+    const LoggerRegistry *registry = instance().owners.load(std::memory_order_acquire);
+    if(registry == nullptr)
+        return;
 
-    QList<QSharedPointer<Output>> outList = instance().loggers.values(owner);
-    foreach(QSharedPointer<Output> out, outList)
+    for(Logger *entry : *registry)
     {
-        if(!out.isNull() && lvl <= out->getConfiguration()->getLogLevel())
+        const OutputList *outList = entry->getOutputs();
+        if(outList == nullptr)
+            continue;
+        for(const QSharedPointer<Output> &out : *outList)
         {
-            out->write(message, owner, lvl, QDateTime::currentDateTime(), functionName, lineNumber);
+            QMutexLocker locker(out->getMutex());
+            out->flushIfDue(now);
         }
     }
-    writex.unlock();
+}
+
+void QLogger::startFlushTimer()
+{
+    QLogger &logger = instance();
+    if(logger.flushTimerStarted.load(std::memory_order_relaxed) || logger.flushTimerStarted.exchange(true))
+        return;
+    logger.flushTimer.reset(new FlushTimer());
+    logger.flushTimer->start();
+}
+
+bool QLogger::isEnabled(Level lvl, const QString &owner)
+{
+    Logger *entry = findLogger(owner);
+    return entry != nullptr && entry->isEnabled(lvl);
+}
+
+Logger *QLogger::findLogger(const QString &owner)
+{
+    SnapshotReader reader;
+    const LoggerRegistry *registry = instance().owners.load(std::memory_order_acquire);
+    return registry != nullptr ? registry->value(owner, nullptr) : nullptr;
+}
+
+const Logger *QLogger::unknownLogger()
+{
+    static const Logger unknown(QString{});
+    return &unknown;
+}
+
+Logger *QLogger::getLogger(const QString &owner)
+{
+    Logger *entry = findLogger(owner);
+    if(entry != nullptr)
+        return entry;
+
+    QLogger &logger = instance();
+    QMutexLocker locker(&registryx);
+    // another thread may have added the owner while we waited
+    const LoggerRegistry *current = logger.owners.load(std::memory_order_relaxed);
+    entry = current != nullptr ? current->value(owner, nullptr) : nullptr;
+    if(entry != nullptr)
+        return entry;
+
+    LoggerRegistry *next = current != nullptr ? new LoggerRegistry(*current) : new LoggerRegistry();
+    entry = new Logger(owner);
+    next->insert(owner, entry);
+    logger.owners.store(next, std::memory_order_release);
+    // readers take no lock, one of them may still be looking at the old registry
+    if(current != nullptr)
+        retire(current);
+    return entry;
+}
+
+void QLogger::retire(const void *snapshot, void (*deleter)(const void *))
+{
+    QLogger &logger = instance();
+    RetiredSnapshot old;
+    old.snapshot = snapshot;
+    old.deleter = deleter;
+    old.epoch = SnapshotReader::retireEpoch();
+    logger.retired.append(old);
+    reclaim();
+}
+
+void QLogger::reclaim()
+{
+    QVector<RetiredSnapshot> &retired = instance().retired;
+    int kept = 0;
+    for(int i = 0 ; i < retired.size() ; i++)
+    {
+        if(SnapshotReader::isReclaimable(retired.at(i).epoch))
+            retired.at(i).deleter(retired.at(i).snapshot);
+        else
+            retired[kept++] = retired.at(i);
+    }
+    retired.resize(kept);
 }
 
 void QLogger::fatal(const QString &message, const QString &owner, const QString &functionName, int lineNumber)
@@ -174,9 +490,24 @@ void QLogger::trace(const QString &message, const QString &owner, const QString
 
 SignalOutput *QLogger::getSignal(const QString &owner)
 {
-    QSharedPointer<Output> out = instance().loggers.value(owner);
-    auto sig = dynamic_cast<SignalOutput*>(out.get());
-    return sig;
+    Logger *entry = findLogger(owner);
+    if(entry == nullptr)
+        return nullptr;
+
+    SnapshotReader reader;
+    const OutputList *outList = entry->getOutputs();
+    // the last signal output added to the owner
+    for(int i = (outList != nullptr ? outList->size() : 0) - 1 ; i >= 0 ; i--)
+    {
+        Output *out = outList->at(i).data();
+        auto isolated = dynamic_cast<IsolatedOutput*>(out);
+        if(isolated != nullptr)
+            out = isolated->getOutput(); // connected slots get the signal queued from the writer thread
+        auto sig = dynamic_cast<SignalOutput*>(out);
+        if(sig != nullptr)
+            return sig;
+    }
+    return nullptr;
 }
 
 QString QLogger::getConfigFilePath(const QString &startingPath, const QString &fileName)
@@ -193,64 +524,210 @@ QString QLogger::getConfigFilePath(const QString &startingPath, const QString &f
     return ""; // file not found
 }
 
-void QLogger::readConfigurationFile()
+//! true if the only keys that changed are the ones a running output can take, see applyLiveSettings
+static bool hasOnlyLiveChanges(const QVariantMap &before, const QVariantMap &after)
+{
+    static const QStringList liveKeys = { CH_LEVEL, CH_LOG_MASK, CH_TIMESTAMP_FORMAT, CH_TIMESTAMP_UTC,
+                                          CH_FLUSH_BUFFER_SIZE, CH_FLUSH_INTERVAL, CH_FLUSH_LEVEL };
+    const QStringList keys = before.keys() + after.keys();
+    for(const QString &key : keys)
+    {
+        if(!liveKeys.contains(key) && before.value(key) != after.value(key))
+            return false;
+    }
+    return true;
+}
+
+Configuration* QLogger::readConfiguration(const QString &owner, const QVariantMap &settings)
+{
+    QString level = settings.value(CH_LEVEL, ERROR_LEVEL).toString();
+    QString mask = settings.value(CH_LOG_MASK, DEFAULT_TEXT_MASK).toString();
+    QString timestamp = settings.value(CH_TIMESTAMP_FORMAT, DEFAULT_TIMESTAMP_FORMAT).toString();
+    QString fileName = settings.value(CH_FILE_NAME, TEXT_FILE_NAME_MASK).toString();
+    QString fileTimestamp = settings.value(CH_FILE_NAME_TIMESTAMP, FILE_NAME_TIMESTAMP_FORMAT).toString();
+    QString path = settings.value(CH_PATH, DEFAULT_LOG_PATH).toString();
+    QString fileSizeStr = settings.value(CH_MAX_FILE_SIZE).toString();
+
+    qint64 fileSize = sizeFromString(fileSizeStr, DEFAULT_FILE_SIZE_MB);
+    QString compression = settings.value(CH_COMPRESS, NONE_COMPRESSION_STR).toString();
+    qint64 maxTotalSize = sizeFromString(settings.value(CH_MAX_TOTAL_SIZE).toString(), NO_RETENTION_LIMIT);
+    int maxFiles = settings.value(CH_MAX_FILES, NO_RETENTION_LIMIT).toInt();
+    int maxAge = settings.value(CH_MAX_AGE, NO_RETENTION_LIMIT).toInt();
+    QString jsonFormat = settings.value(CH_JSON_FORMAT, JSON_DOCUMENT_STR).toString();
+    int isolatedQueue = settings.value(CH_ISOLATED_QUEUE, NOT_ISOLATED).toInt();
+    bool nativeLineEndings = settings.value(CH_NATIVE_LINE_ENDINGS, true).toBool();
+
+    Configuration* configuration = new Configuration(owner, levelFromString(level), mask, timestamp,
+                                                     fileName, fileTimestamp, path, fileSize);
+    applyLiveSettings(configuration, settings);
+    configuration->setCompression(compressionFromString(compression));
+    configuration->setMaxTotalSize(maxTotalSize);
+    configuration->setMaxFiles(maxFiles);
+    configuration->setMaxAgeDays(maxAge);
+    configuration->setJsonFormat(jsonFormatFromString(jsonFormat));
+    configuration->setIsolatedQueueCapacity(isolatedQueue);
+    configuration->setNativeLineEndings(nativeLineEndings);
+    return configuration;
+}
+
+void QLogger::applyLiveSettings(Configuration *configuration, const QVariantMap &settings)
+{
+    QString level = settings.value(CH_LEVEL, ERROR_LEVEL).toString();
+    QString mask = settings.value(CH_LOG_MASK, DEFAULT_TEXT_MASK).toString();
+    QString timestamp = settings.value(CH_TIMESTAMP_FORMAT, DEFAULT_TIMESTAMP_FORMAT).toString();
+    bool timestampUtc = settings.value(CH_TIMESTAMP_UTC, false).toBool();
+    qint64 flushBufferSize = sizeFromString(settings.value(CH_FLUSH_BUFFER_SIZE).toString(), DEFAULT_FLUSH_POLICY);
+    int flushInterval = settings.value(CH_FLUSH_INTERVAL, DEFAULT_FLUSH_POLICY).toInt();
+    QString flushLevel = settings.value(CH_FLUSH_LEVEL).toString();
+
+    configuration->setLogLevel(levelFromString(level));
+    // the setters rebuild the compiled mask and the formatters, skipped when nothing changed
+    if(configuration->getLogTextMask() != mask)
+        configuration->setLogTextMask(mask);
+    if(configuration->getTimestampFormat() != timestamp)
+        configuration->setTimestampFormat(timestamp);
+    if(configuration->isTimestampUtc() != timestampUtc)
+        configuration->setTimestampUtc(timestampUtc);
+    configuration->setFlushBufferSize(flushBufferSize);
+    configuration->setFlushInterval(flushInterval);
+    configuration->setFlushLevel(flushLevel.isEmpty() ? DEFAULT_FLUSH_POLICY : levelFromString(flushLevel));
+}
+
+void QLogger::readConfigurationFile(QFileSystemWatcher *watcher)
 {
-    QSettings settings(getConfigFilePath(QDir::currentPath(), CH_CONFIG_FILE_NAME), QSettings::IniFormat);
+    // the watcher and a direct reload may read the file at the same time
+    static QMutex readx;
+    QMutexLocker readLocker(&readx);
 
+    QLogger &logger = instance();
+    QScopedPointer<QSettings> file(new QSettings(getConfigFilePath(QDir::currentPath(), CH_CONFIG_FILE_NAME),
+                                                 QSettings::IniFormat));
     //traverse the "log owners settings"
-    QStringList owners = settings.childGroups();
+    QStringList owners = file->childGroups();
+    if(owners.isEmpty() && !logger.fileOwners.isEmpty() && watcher != nullptr)
+    {
+        // an editor saving the file may leave it empty or missing for a moment, it is read once more before
+        // the running owners are removed, the watcher thread goes on with its events meanwhile
+        QTimer::singleShot(CONFIG_REREAD_DELAY_MS, watcher, []() { readConfigurationFile(); });
+        return;
+    }
+    // a file that can not be read keeps the running owners, a deleted or empty one removes them
+    if(file->status() != QSettings::NoError)
+        return;
+    QSettings &settings = *file;
+
+    QHash<QString, FileOwner> current;
     QStringList::const_iterator it;
     for(it = owners.constBegin() ; it != owners.constEnd() ; ++it)
     {
+        QVariantMap ownerSettings;
         settings.beginGroup((*it)); // start reading setting from the current owner
-            QString level = settings.value(CH_LEVEL, ERROR_LEVEL).toString();
-            QString outStr = settings.value(CH_OUTPUT_TYPE, CONSOLE_OUTPUT).toString(); //console
-            QString mask = settings.value(CH_LOG_MASK, DEFAULT_TEXT_MASK).toString();
-            QString timestamp = settings.value(CH_TIMESTAMP_FORMAT, DEFAULT_TIMESTAMP_FORMAT).toString();
-            QString fileName = settings.value(CH_FILE_NAME, TEXT_FILE_NAME_MASK).toString();
-            QString fileTimestamp = settings.value(CH_FILE_NAME_TIMESTAMP, FILE_NAME_TIMESTAMP_FORMAT).toString();
-            QString path = settings.value(CH_PATH, DEFAULT_LOG_PATH).toString();
-            QString fileSizeStr = settings.value(CH_MAX_FILE_SIZE).toString();
-
-            // in this option is possible to pass file sizes in plain int (number of bytes) or with the following options
-            // x Mb, xM, xm, xMB, x mb, xKB, xk, xK, xKb, xkb, xg, xG, xgb, xGb, xGB as x being the desired number.
-            QRegularExpression splitNumbers("^(\\d+)|\\s?([KMGkmg]{1,1}[Bb]{0,1})$");
-            //if fails to consume considers the default;
-            qint64 fileSize = DEFAULT_FILE_SIZE_MB;
-            QRegularExpressionMatchIterator matchIt = splitNumbers.globalMatch(fileSizeStr);
-            qint64 multiplier = 1;
-            bool isOk = false;
-            qint64 tempSize = 0;
-            while(matchIt.hasNext())
+            const QStringList keys = settings.childKeys();
+            for(const QString &key : keys)
+                ownerSettings.insert(key, settings.value(key));
+        settings.endGroup();
+
+        FileOwner entry = logger.fileOwners.value((*it));
+        if(!entry.output.isNull() && entry.settings == ownerSettings)
+        {
+            // nothing changed, the output and its files are kept as they are
+            current.insert((*it), entry);
+            continue;
+        }
+
+        if(!entry.output.isNull() && hasOnlyLiveChanges(entry.settings, ownerSettings))
+        {
+            // the output that writes is the one holding the configuration mutex
+            Output *writer = entry.output.data();
+            IsolatedOutput *isolated = dynamic_cast<IsolatedOutput*>(writer);
+            if(isolated != nullptr)
+                writer = isolated->getOutput();
             {
-                QRegularExpressionMatch match = matchIt.next();
-                QString token = match.captured();
-                tempSize = token.toLong(&isOk);
-                if(!isOk)
-                {
-                    if(token.contains('k', Qt::CaseInsensitive))
-                    {
-                        multiplier = 1000; // 1kb
-                    }
-                    else if(token.contains('m', Qt::CaseInsensitive))
-                    {
-                        multiplier = 1000000; // 1mb
-                    }
-                    else if(token.contains('g', Qt::CaseInsensitive))
-                    {
-                        multiplier = 1000000000; // 1gb
-                    }
-                }
-                else
-                {
-                    fileSize = tempSize;
-                }
+                QMutexLocker locker(writer->getMutex());
+                applyLiveSettings(entry.output->getConfiguration().data(), ownerSettings);
             }
-            fileSize *= multiplier;
-        settings.endGroup();
-        QLogger::addLogger((*it), levelFromString(level), ouputFromString(outStr), mask, timestamp, fileName, fileTimestamp, path, fileSize);
+            Logger *ownerEntry = findLogger((*it));
+            {
+                QMutexLocker locker(&registryx);
+                ownerEntry->updateLevel();
+            }
+            entry.settings = ownerSettings;
+            current.insert((*it), entry);
+            continue;
+        }
+
+        // a new owner or a key that needs a new output, it takes the place of the old one
+        Configuration* configuration = readConfiguration((*it), ownerSettings);
+        if(!configuration->validate())
+        {
+            // an invalid change keeps the owner running with what it had
+            delete configuration;
+            if(!entry.output.isNull())
+                current.insert((*it), entry);
+            continue;
+        }
+        QString outStr = ownerSettings.value(CH_OUTPUT_TYPE, CONSOLE_OUTPUT).toString(); //console
+        entry.output = publishOutput(configuration, createOutput(configuration, ouputFromString(outStr)), entry.output);
+        entry.settings = ownerSettings;
+        current.insert((*it), entry);
     }
 
+    // the owners taken out of the file lose their output
+    QHash<QString, FileOwner>::const_iterator removed;
+    for(removed = logger.fileOwners.constBegin() ; removed != logger.fileOwners.constEnd() ; ++removed)
+    {
+        if(current.contains(removed.key()))
+            continue;
+        Logger *ownerEntry = findLogger(removed.key());
+        QMutexLocker locker(&registryx);
+        ownerEntry->replaceOutput(removed.value().output, QSharedPointer<Output>());
+    }
+    logger.fileOwners = current;
+}
+
+void QLogger::reloadConfigurationFile()
+{
+    // the first instance call reads the file already
+    instance();
+    readConfigurationFile();
+}
+
+void QLogger::watchConfigurationFile(bool enabled)
+{
+    QLogger &logger = instance();
+    if(!enabled)
+    {
+        logger.configWatcher.reset();
+        return;
+    }
+    if(!logger.configWatcher.isNull())
+        return;
+
+    const QString path = getConfigFilePath(QDir::currentPath(), CH_CONFIG_FILE_NAME);
+    if(path.isEmpty())
+        return; // no file to watch
+
+    QFileSystemWatcher *watcher = new QFileSystemWatcher();
+    watcher->addPath(path);
+    // an editor may save the file by replacing it, the folder tells when it is back
+    watcher->addPath(QFileInfo(path).absolutePath());
+    QObject::connect(watcher, &QFileSystemWatcher::fileChanged, [watcher, path]()
+    {
+        // also emitted when the file is deleted, the reload then removes its owners
+        if(!watcher->files().contains(path) && QFileInfo::exists(path))
+            watcher->addPath(path);
+        readConfigurationFile(watcher);
+    });
+    QObject::connect(watcher, &QFileSystemWatcher::directoryChanged, [watcher, path]()
+    {
+        // the folder also changes when a log file is created, only a file that was replaced is read
+        if(!watcher->files().contains(path) && QFileInfo::exists(path))
+        {
+            watcher->addPath(path);
+            readConfigurationFile(watcher);
+        }
+    });
+    logger.configWatcher.reset(watcher);
 }
 
 }
@@ -22,21 +22,37 @@
 #ifndef QLOGGER_H
 #define QLOGGER_H
 
+#include <atomic>
+
 #include <QMutex>
+#include <QScopedPointer>
 #include <QSharedPointer>
 #include <QHash>
+#include <QVariant>
+#include <QVector>
 
 #include "qloggerlib_global.h"
 #include "configuration.h"
+#include "logrecord.h"
+#include "logger.h"
+#include "snapshotreader.h"
 
 #include "consoleoutput.h"
 #include "textoutput.h"
 #include "xmloutput.h"
 #include "signaloutput.h"
 
+class QFileSystemWatcher;
+
 namespace qlogger
 {
 
+class AsyncBackend;
+class FlushTimer;
+
+//! the owner entries by name, once published a registry is never changed, a new one replaces it
+typedef QHash<QString, Logger*> LoggerRegistry;
+
 //!
 //! \brief The QLogger class is the main QLogger class, its a singleton responsible for
 //! register the log messages to its respective owners and also load the runtime configurations
@@ -66,6 +82,14 @@ public:
     //!
     static void addLogger(Configuration *configuration, OutputType type = CONSOLE);
 
+    //!
+    //! \brief createOutput - creates the output object of a type, the output takes ownership of the configuration
+    //! \param configuration - a non null configuration
+    //! \param type - the type of output to be created
+    //! \return the new output
+    //!
+    static Output* createOutput(Configuration *configuration, OutputType type);
+
     //!
     //! \brief addLogger - adds a logger with a default configuration to the list of loggers in runtime
     //! \param logOwner - the name of the log owner
@@ -161,6 +185,79 @@ public:
     //!
     static SignalOutput* getSignal(const QString &owner);
 
+    //!
+    //! \brief setAsynchronous - turns the asynchronous mode on or off, on asynchronous mode a log call only
+    //! captures the record into a bounded lock-free queue and a dedicated thread writes it to the outputs,
+    //! so the calling threads never wait on disk i/o. Turning it off waits for the logs being queued by other
+    //! threads and writes every pending record, it must not be called from an output.
+    //! \param enabled - true to log asynchronously, false to write on the calling thread (default)
+    //! \param queueCapacity - max number of records waiting to be written, when full the callers wait
+    //! for room, only used the first time the asynchronous mode is turned on
+    //!
+    static void setAsynchronous(bool enabled, int queueCapacity = DEFAULT_QUEUE_CAPACITY);
+
+    //!
+    //! \brief isAsynchronous - true if qlogger is working on asynchronous mode
+    //!
+    static bool isAsynchronous();
+
+    //!
+    //! \brief flush - writes every buffered log to its output, on asynchronous mode it waits for the logs
+    //! queued before this call to be written first, isolated outputs are waited for after the others
+    //!
+    static void flush();
+
+    //!
+    //! \brief getDroppedCount - the logs the isolated outputs of the owner dropped because their queue was full
+    //! \param owner - the owner of the log
+    //!
+    static quint64 getDroppedCount(const QString &owner);
+
+    //!
+    //! \brief isEnabled - tells if any output of the owner accepts the level, use it to skip building
+    //! expensive messages when not using the macros (the macros already do this check)
+    //! \param lvl - the level to be checked
+    //! \param owner - the owner of the log
+    //!
+    static bool isEnabled(Level lvl, const QString &owner = "root");
+
+    //!
+    //! \brief getLogger - returns the handle of an owner, logging through the handle skips the owner lookup
+    //! done by the static log methods, the handle is valid as long as qlogger lives so it can be kept
+    //! (on a static, a member...) and it can be taken before the owner outputs are added
+    //! \param owner - the name of the log owner
+    //! \return the owner handle, never nullptr
+    //!
+    static Logger* getLogger(const QString &owner);
+
+    //!
+    //! \brief findLogger - retrieves the handle of an owner without creating it, the level checks and the logs
+    //! of an unknown owner use it so they never add an entry to the registry
+    //! \param owner - the name of the log owner
+    //! \return the owner handle or nullptr if the owner is unknown
+    //!
+    static Logger* findLogger(const QString &owner);
+
+    //!
+    //! \brief watchConfigurationFile - turns the reload of the configuration file on or off, when on the file found
+    //! on start up is watched and read again every time it changes, see reloadConfigurationFile. The watcher
+    //! lives on the calling thread, that needs a running event loop
+    //! \param enabled - true to reload the configuration file when it changes, false (default) to stop watching it
+    //!
+    static void watchConfigurationFile(bool enabled);
+
+    //!
+    //! \brief reloadConfigurationFile - reads the configuration file again and applies what changed: level, logMask,
+    //! timestampFormat, timestampUtc and the flush settings are changed on the running outputs, an owner with any
+    //! other key changed gets a new output that replaces the old one, the owners added or removed from the file
+    //! are added or removed, as all of them when the file is deleted. A file the watcher finds empty or missing is
+    //! read once more after CONFIG_REREAD_DELAY_MS, as an editor may be saving it, and a file that can not be read
+    //! keeps the running owners. The owners that did not change keep their outputs and files untouched.
+    //! Logs are never dropped: they go to the outputs published when they are written and a replaced output
+    //! writes what it has buffered when it is deleted, once no thread is writing to it.
+    //!
+    static void reloadConfigurationFile();
+
 protected:
 
     //!
@@ -178,54 +275,347 @@ protected:
     //!
     //! [owner]
     //! level = { FATAL, ERROR, WARN, INFO, DEBUG, TRACE }
-    //! outputType = { CONSOLE, TEXT, XML }
+    //! outputType = { CONSOLE, TEXT, XML, JSON, BINARY }
     //! logMask = { for console and text can use the symbols %t %o %l %m , if does not contain %t %l and %m will use the default }
     //! maxFileSize = {in kb just a number 100, 1000... only for TEXT and XML}
     //! path = { a valid absolut path on the system, if invalid path is given then will default to app path }
     //! timestampFormat = { the Qt format for datetime used to format the %t part of console and text and date_time tag of XML, it defaults to platform short format }
     //! fileName = { file name mask, must contain all %1 %2 %3 params, example: log_%1_%2_%3.txt
     //! fileNameTimeStamp = { the timestamp that will be written in param %3 of the file name mask, must follow QTimeDate string format.
+    //! timestampUtc = { true to write the log time in UTC, false (default) for local time }
+    //! flushBufferSize = { bytes buffered before writing to the io, same format as maxFileSize, 0 flushes every log }
+    //! flushInterval = { max milliseconds a log stays buffered, 0 to not flush by time }
+    //! flushLevel = { logs of this level or more severe are flushed right away, FATAL ... TRACE }
+    //! compress = { none (default), gzip - rotated files are compressed to .gz, zlib is the same as gzip }
+    //! maxTotalSize = { max size of all the log files of the owner, same format as maxFileSize, 0 (default) for no limit }
+    //! maxFiles = { max number of log files of the owner, 0 (default) for no limit }
+    //! maxAge = { days a log file is kept after it was last written, 0 (default) for no limit }
+    //! jsonFormat = { document (default) - a json document per file, lines - one json log per line (NDJSON) }
+    //! isolatedQueue = { logs queued for a writer thread of the output's own, 0 (default) to write on qlogger threads }
+    //! nativeLineEndings = { true (default) - lines end as the platform does (\r\n on windows), false - \n everywhere }
     //!
     //! [another_owner]
     //! ...
-    static void readConfigurationFile();
+    //!
+    //! called again on every reload, only the owners whose keys changed since the last read are touched
+    //! \param watcher - the watcher that saw the file change, it reads an empty or missing file once more after
+    //! CONFIG_REREAD_DELAY_MS on its own event loop, nullptr applies what is read right away
+    static void readConfigurationFile(QFileSystemWatcher *watcher = nullptr);
+
+    //!
+    //! \brief readConfiguration - builds the configuration of an owner from its keys on the configuration file
+    //! \param owner - the name of the log owner
+    //! \param settings - the keys of the owner group
+    //! \return the new configuration
+    //!
+    static Configuration* readConfiguration(const QString &owner, const QVariantMap &settings);
+
+    //!
+    //! \brief applyLiveSettings - changes the keys that a running output can take on its configuration, level,
+    //! logMask, timestampFormat, timestampUtc and the flush settings, the output mutex must be locked
+    //! \param configuration - the configuration of the running output
+    //! \param settings - the keys of the owner group
+    //!
+    static void applyLiveSettings(Configuration *configuration, const QVariantMap &settings);
 
 private:
     //! protected constructor to avoid instatiation outside the class
     QLogger() = default;
-    ~QLogger() = default;
+    ~QLogger();
     QLogger(const QLogger&) = delete;
     QLogger(QLogger&&) = delete;
     QLogger& operator=(const QLogger&) = delete;
     QLogger& operator=(QLogger&&) = delete;
 
+    //!
+    //! \brief dispatch - writes a record to every output of its owner, each output with its own mutex locked
+    //! \param record - the record to be written, a deferred message is formatted in place
+    //!
+    static void dispatch(LogRecord &record);
+
+    //!
+    //! \brief dispatchBatch - writes records to the outputs of their owners, the records in a row with the same
+    //! outputs go to each output as a single batch, each output with its own mutex locked
+    //! \param records - the records to be written, deferred messages are formatted in place
+    //! \param count - the number of records
+    //!
+    static void dispatchBatch(LogRecord *records, int count);
+
+    //!
+    //! \brief submit - hands a record to the backend on asynchronous mode or writes it right away
+    //! \param record - the record to be written, it may be moved from
+    //!
+    static void submit(LogRecord &record);
+
+    //!
+    //! \brief flushDue - flushes the outputs with logs waiting longer than their flush interval
+    //! \param now - the current time in nanoseconds since epoch
+    //!
+    static void flushDue(qint64 now);
+
+    //!
+    //! \brief startFlushTimer - starts the flush timer the first time an output keeps logs buffered on
+    //! synchronous mode, see FlushTimer
+    //!
+    static void startFlushTimer();
+
+    //!
+    //! \brief publishOutput - wraps the output if its configuration is isolated and publishes it on its owner
+    //! \param configuration - a valid configuration, owned by the output
+    //! \param output - the output to be published
+    //! \param replaced - the output of the owner it replaces, or a null pointer to add it
+    //! \return the published output
+    //!
+    static QSharedPointer<Output> publishOutput(Configuration *configuration, Output *output,
+                                                const QSharedPointer<Output> &replaced = QSharedPointer<Output>());
+
+    //!
+    //! \brief retire - deletes a snapshot that was replaced once no thread can be reading it anymore,
+    //! must be called with registryx locked
+    //! \param snapshot - the registry or output list that is no longer published
+    //!
+    template <typename T>
+    static void retire(const T *snapshot)
+    {
+        retire(snapshot, [](const void *retired) { delete static_cast<const T*>(retired); });
+    }
+
+    //! retires a snapshot with the function that deletes it
+    static void retire(const void *snapshot, void (*deleter)(const void*));
+
+    //!
+    //! \brief reclaim - deletes the retired snapshots no thread is reading, must be called with registryx locked
+    //!
+    static void reclaim();
+
+    //!
+    //! \brief unknownLogger - the entry returned to the call sites of an unknown owner, it has no outputs and
+    //! it is not in the registry
+    //!
+    static const Logger* unknownLogger();
+
+    friend class AsyncBackend;
+    friend class FlushTimer;
+    friend class Logger;
+    friend class LoggerCache;
+    friend class Output;
+
 private:
 
     //!
-    //! \brief writex - log writing mutex to be (used with threads)
+    //! \brief writex - held by the asynchronous backend while it writes a batch, so flush can wait for the
+    //! batch in progress, synchronous logs only lock the outputs they write to (see Output::getMutex)
     //!
     static QMutex writex;
 
+    //!
+    //! \brief registryx - serializes the changes of the registry and of the output lists, readers take no lock
+    //!
+    static QMutex registryx;
+
     //!
     //! \brief instanceFlag - controls if the instance was called once
     //!
     static bool instanceFlag;
 
     //!
-    //! \brief loggers - the owner / output relationship, it stores loggers based on owner name, tha may
-    //! have more than one type of output/configuration
+    //! \brief owners - the owner / output relationship, one entry per owner name that holds all of its
+    //! outputs, that may have more than one type of output/configuration. Entries are never removed.
+    //! It is read without any lock inside a SnapshotReader, a new owner publishes a copy of the registry with the
+    //! entry added and retires the old one
+    //!
+    std::atomic<const LoggerRegistry*> owners{nullptr};
+
+    //! a snapshot waiting for its readers to finish
+    struct RetiredSnapshot
+    {
+        const void *snapshot;
+        void (*deleter)(const void*);
+        quint64 epoch;
+    };
+
+    //!
+    //! \brief retired - the replaced registries and output lists some thread may still be reading, guarded by
+    //! registryx, see SnapshotReader
     //!
-    QMultiHash<QString, QSharedPointer<Output>> loggers;
+    QVector<RetiredSnapshot> retired;
+
+    //!
+    //! \brief asyncBackend - owns the backend thread, created the first time the asynchronous mode is turned on
+    //!
+    QScopedPointer<AsyncBackend> asyncBackend;
+
+    //!
+    //! \brief backend - the active backend, nullptr while on synchronous mode
+    //!
+    std::atomic<AsyncBackend*> backend{nullptr};
+
+    //!
+    //! \brief flushTimer - flushes the quiet outputs on synchronous mode, created by startFlushTimer
+    //!
+    QScopedPointer<FlushTimer> flushTimer;
+
+    //!
+    //! \brief flushTimerStarted - true once startFlushTimer created the timer
+    //!
+    std::atomic<bool> flushTimerStarted{false};
+
+    //! an owner read from the configuration file
+    struct FileOwner
+    {
+        QSharedPointer<Output> output;
+        QVariantMap settings;
+    };
+
+    //!
+    //! \brief fileOwners - the output published for each owner of the configuration file and the keys it was
+    //! created with, compared on a reload to find what changed. Only used by readConfigurationFile
+    //!
+    QHash<QString, FileOwner> fileOwners;
+
+    //!
+    //! \brief configWatcher - watches the configuration file while the reload is on, see watchConfigurationFile
+    //!
+    QScopedPointer<QFileSystemWatcher> configWatcher;
 
 };
 
+template <typename Owner>
+inline const Logger* LoggerCache::resolve(const Owner &owner)
+{
+    Logger *entry = logger.load(std::memory_order_acquire);
+    if(entry == nullptr || !entry->isOwner(owner))
+    {
+        // an unknown owner is looked up again on the next log, it may have an output by then
+        entry = QLogger::findLogger(owner);
+        if(entry == nullptr)
+            return QLogger::unknownLogger();
+        logger.store(entry, std::memory_order_release);
+    }
+    return entry;
+}
+
+inline const Logger* LoggerCache::resolve()
+{
+    return resolve("root");
+}
+
+//! defines the static descriptor of a call site, constant initialized so it costs nothing on each call
+#define QLOGGER_CALL_SITE(lvl) \
+    static qlogger::CallSite qloggerSite(__FUNCTION__, __FILE__, __LINE__, lvl);
+
+//! logs through the logger handle if the level of the call site is enabled, the message is only evaluated then
+#define QLOGGER_LOG_AT(logger, message) \
+    const qlogger::Logger *qloggerHandle = (logger); \
+    if(qloggerHandle->isEnabled(qloggerSite.level)) \
+        qloggerHandle->log(qloggerSite, message);
+
+//! same as QLOGGER_LOG_AT but the message is formatted later, from a string literal format and its arguments
+#define QLOGGER_LOGF_AT(logger, format, ...) \
+    const qlogger::Logger *qloggerHandle = (logger); \
+    if(qloggerHandle->isEnabled(qloggerSite.level)) \
+        qloggerHandle->logFormat(qloggerSite, format, ##__VA_ARGS__);
+
+//! checks the level on the call site before the message is evaluated, then logs through the logger handle
+#define QLOGGER_LOG_TO(logger, lvl, message) \
+    do { \
+        QLOGGER_CALL_SITE(lvl) \
+        QLOGGER_LOG_AT(logger, message) \
+    } while(false);
+
+//! same as QLOGGER_LOG_TO but the message is formatted later, from a string literal format and its arguments
+#define QLOGGER_LOGF_TO(logger, lvl, format, ...) \
+    do { \
+        QLOGGER_CALL_SITE(lvl) \
+        QLOGGER_LOGF_AT(logger, format, ##__VA_ARGS__) \
+    } while(false);
+
+//! resolves the owner handle once per call site and logs a deferred format through it
+#define QLOGGER_LOGF(lvl, owner, format, ...) \
+    do { \
+        QLOGGER_CALL_SITE(lvl) \
+        QLOGGER_LOGF_AT(qloggerSite.owner.resolve(owner), format, ##__VA_ARGS__) \
+    } while(false);
+
+//! resolves the owner handle once per call site and logs through it
+#define QLOGGER_LOG(lvl, message, ...) \
+    do { \
+        QLOGGER_CALL_SITE(lvl) \
+        QLOGGER_LOG_AT(qloggerSite.owner.resolve(__VA_ARGS__), message) \
+    } while(false);
+
+//! a log stripped at compile time, see QLOGGER_COMPILE_MIN_LEVEL, nothing is evaluated
+#define QLOGGER_STRIPPED() do { } while(false);
+
 //! MACROS FOR THE PEOPLE!
-#define QLOG_FATAL(message, ...) QLogger::log(q0FATAL, message, __FUNCTION__ , __LINE__, ##__VA_ARGS__);
-#define QLOG_ERROR(message, ...) QLogger::log(q1ERROR, message, __FUNCTION__ , __LINE__ , ##__VA_ARGS__);
-#define QLOG_WARN(message, ...) QLogger::log(q2WARN, message, __FUNCTION__ , __LINE__ , ##__VA_ARGS__);
-#define QLOG_INFO(message, ...) QLogger::log(q3INFO, message, __FUNCTION__ , __LINE__ , ##__VA_ARGS__);
-#define QLOG_DEBUG(message, ...) QLogger::log(q4DEBUG, message, __FUNCTION__ , __LINE__ , ##__VA_ARGS__);
-#define QLOG_TRACE(message, ...) QLogger::log(q5TRACE, message, __FUNCTION__ , __LINE__ , ##__VA_ARGS__);
+//! QLOG_* log to an owner (root by default), QLOGL_* to a handle from QLogger::getLogger, the F variants take
+//! a string literal format and its arguments, formatted only when the log is written:
+//! QLOGF_WARN("file", "a warn log n:%1 of %2 !", i, count);
+//! the ones more verbose than QLOGGER_COMPILE_MIN_LEVEL are compiled out, fatal is always kept
+#define QLOG_FATAL(message, ...) QLOGGER_LOG(qlogger::q0FATAL, message, ##__VA_ARGS__)
+#define QLOGL_FATAL(logger, message) QLOGGER_LOG_TO(logger, qlogger::q0FATAL, message)
+#define QLOGF_FATAL(owner, format, ...) QLOGGER_LOGF(qlogger::q0FATAL, owner, format, ##__VA_ARGS__)
+#define QLOGLF_FATAL(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q0FATAL, format, ##__VA_ARGS__)
+
+#if QLOGGER_COMPILE_MIN_LEVEL >= 1
+#define QLOG_ERROR(message, ...) QLOGGER_LOG(qlogger::q1ERROR, message, ##__VA_ARGS__)
+#define QLOGL_ERROR(logger, message) QLOGGER_LOG_TO(logger, qlogger::q1ERROR, message)
+#define QLOGF_ERROR(owner, format, ...) QLOGGER_LOGF(qlogger::q1ERROR, owner, format, ##__VA_ARGS__)
+#define QLOGLF_ERROR(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q1ERROR, format, ##__VA_ARGS__)
+#else
+#define QLOG_ERROR(message, ...) QLOGGER_STRIPPED()
+#define QLOGL_ERROR(logger, message) QLOGGER_STRIPPED()
+#define QLOGF_ERROR(owner, format, ...) QLOGGER_STRIPPED()
+#define QLOGLF_ERROR(logger, format, ...) QLOGGER_STRIPPED()
+#endif
+
+#if QLOGGER_COMPILE_MIN_LEVEL >= 2
+#define QLOG_WARN(message, ...) QLOGGER_LOG(qlogger::q2WARN, message, ##__VA_ARGS__)
+#define QLOGL_WARN(logger, message) QLOGGER_LOG_TO(logger, qlogger::q2WARN, message)
+#define QLOGF_WARN(owner, format, ...) QLOGGER_LOGF(qlogger::q2WARN, owner, format, ##__VA_ARGS__)
+#define QLOGLF_WARN(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q2WARN, format, ##__VA_ARGS__)
+#else
+#define QLOG_WARN(message, ...) QLOGGER_STRIPPED()
+#define QLOGL_WARN(logger, message) QLOGGER_STRIPPED()
+#define QLOGF_WARN(owner, format, ...) QLOGGER_STRIPPED()
+#define QLOGLF_WARN(logger, format, ...) QLOGGER_STRIPPED()
+#endif
+
+#if QLOGGER_COMPILE_MIN_LEVEL >= 3
+#define QLOG_INFO(message, ...) QLOGGER_LOG(qlogger::q3INFO, message, ##__VA_ARGS__)
+#define QLOGL_INFO(logger, message) QLOGGER_LOG_TO(logger, qlogger::q3INFO, message)
+#define QLOGF_INFO(owner, format, ...) QLOGGER_LOGF(qlogger::q3INFO, owner, format, ##__VA_ARGS__)
+#define QLOGLF_INFO(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q3INFO, format, ##__VA_ARGS__)
+#else
+#define QLOG_INFO(message, ...) QLOGGER_STRIPPED()
+#define QLOGL_INFO(logger, message) QLOGGER_STRIPPED()
+#define QLOGF_INFO(owner, format, ...) QLOGGER_STRIPPED()
+#define QLOGLF_INFO(logger, format, ...) QLOGGER_STRIPPED()
+#endif
+
+#if QLOGGER_COMPILE_MIN_LEVEL >= 4
+#define QLOG_DEBUG(message, ...) QLOGGER_LOG(qlogger::q4DEBUG, message, ##__VA_ARGS__)
+#define QLOGL_DEBUG(logger, message) QLOGGER_LOG_TO(logger, qlogger::q4DEBUG, message)
+#define QLOGF_DEBUG(owner, format, ...) QLOGGER_LOGF(qlogger::q4DEBUG, owner, format, ##__VA_ARGS__)
+#define QLOGLF_DEBUG(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q4DEBUG, format, ##__VA_ARGS__)
+#else
+#define QLOG_DEBUG(message, ...) QLOGGER_STRIPPED()
+#define QLOGL_DEBUG(logger, message) QLOGGER_STRIPPED()
+#define QLOGF_DEBUG(owner, format, ...) QLOGGER_STRIPPED()
+#define QLOGLF_DEBUG(logger, format, ...) QLOGGER_STRIPPED()
+#endif
+
+#if QLOGGER_COMPILE_MIN_LEVEL >= 5
+#define QLOG_TRACE(message, ...) QLOGGER_LOG(qlogger::q5TRACE, message, ##__VA_ARGS__)
+#define QLOGL_TRACE(logger, message) QLOGGER_LOG_TO(logger, qlogger::q5TRACE, message)
+#define QLOGF_TRACE(owner, format, ...) QLOGGER_LOGF(qlogger::q5TRACE, owner, format, ##__VA_ARGS__)
+#define QLOGLF_TRACE(logger, format, ...) QLOGGER_LOGF_TO(logger, qlogger::q5TRACE, format, ##__VA_ARGS__)
+#else
+#define QLOG_TRACE(message, ...) QLOGGER_STRIPPED()
+#define QLOGL_TRACE(logger, message) QLOGGER_STRIPPED()
+#define QLOGF_TRACE(owner, format, ...) QLOGGER_STRIPPED()
+#define QLOGLF_TRACE(logger, format, ...) QLOGGER_STRIPPED()
+#endif
 
 }
 
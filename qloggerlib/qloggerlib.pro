@@ -21,6 +21,12 @@ DEFINES += QT_DEPRECATED_WARNINGS
 # You can also select to disable deprecated APIs only up to a certain version of Qt.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Log levels more verbose than QLOGGER_COMPILE_MIN_LEVEL are stripped at compile time, their QLOG_* macros
+# expand to nothing and the message is never evaluated. Uses the level values: 0 = FATAL, 1 = ERROR,
+# 2 = WARN, 3 = INFO, 4 = DEBUG, 5 = TRACE (default, keeps everything). The macros are expanded on the
+# code that includes qlogger.h, so the same define must be set on the application project too.
+#CONFIG(release, debug|release): DEFINES += QLOGGER_COMPILE_MIN_LEVEL=3
+
 SOURCES += xmloutput.cpp \
     textoutput.cpp \
     qlogger.cpp \
@@ -28,7 +34,24 @@ SOURCES += xmloutput.cpp \
     consoleoutput.cpp \
     output.cpp \
     signaloutput.cpp \
-    jsonoutput.cpp
+    jsonoutput.cpp \
+    asyncbackend.cpp \
+    logger.cpp \
+    logarguments.cpp \
+    logtextmask.cpp \
+    timestampformatter.cpp \
+    fileworker.cpp \
+    filecompression.cpp \
+    fileretention.cpp \
+    binarylog.cpp \
+    binaryoutput.cpp \
+    textescape.cpp \
+    utf8.cpp \
+    callsite.cpp \
+    rendercache.cpp \
+    isolatedoutput.cpp \
+    snapshotreader.cpp \
+    flushtimer.cpp
 
 HEADERS += \
     xmloutput.h \
@@ -39,7 +62,26 @@ HEADERS += \
     qloggerlib_global.h \
     consoleoutput.h \
     signaloutput.h \
-    jsonoutput.h
+    jsonoutput.h \
+    logrecord.h \
+    logqueue.h \
+    asyncbackend.h \
+    logger.h \
+    logarguments.h \
+    logtextmask.h \
+    timestampformatter.h \
+    fileworker.h \
+    filecompression.h \
+    fileretention.h \
+    binarylog.h \
+    binaryoutput.h \
+    textescape.h \
+    utf8.h \
+    callsite.h \
+    rendercache.h \
+    isolatedoutput.h \
+    snapshotreader.h \
+    flushtimer.h
 
 unix {
     target.path = /usr/lib
@@ -22,10 +22,16 @@
 #ifndef QLOGGERLIB_GLOBAL_H
 #define QLOGGERLIB_GLOBAL_H
 
+#include <chrono>
+
 #include <QCoreApplication>
+#include <QDateTime>
+#include <QRegularExpression>
 #include <QtCore/qglobal.h>
 #include <QString>
 
+#include "logtextmask.h"
+
 //evaluate if a dynamic library would be better... it constrains the use of macro for log
 /*
 #if defined(QLOGGERLIB_LIBRARY)
@@ -49,6 +55,12 @@ enum Level
     q0FATAL, q1ERROR, q2WARN, q3INFO, q4DEBUG, q5TRACE
 };
 
+//! the most verbose level compiled in, log macros of more verbose levels expand to nothing and their
+//! arguments are never evaluated. Uses the Level values, 0 = FATAL ... 5 = TRACE (keeps everything).
+#ifndef QLOGGER_COMPILE_MIN_LEVEL
+#define QLOGGER_COMPILE_MIN_LEVEL 5
+#endif
+
 //!
 static const QString FATAL_LEVEL = "FATAL";
 static const QString ERROR_LEVEL = "ERROR";
@@ -57,12 +69,14 @@ static const QString INFO_LEVEL = "INFO";
 static const QString DEBUG_LEVEL = "DEBUG";
 static const QString TRACE_LEVEL = "TRACE";
 static const int NUM_LEVEL = 6;
+//! used where no level is enabled at all
+static const int NO_LEVEL = -1;
 static const QString levelsbuf[NUM_LEVEL] = { FATAL_LEVEL, ERROR_LEVEL, WARN_LEVEL, INFO_LEVEL, DEBUG_LEVEL, TRACE_LEVEL };
 
 //!
 enum OutputType
 {
-    CONSOLE, TEXTFILE, XMLFILE, SIGNAL, JSON
+    CONSOLE, TEXTFILE, XMLFILE, SIGNAL, JSON, BINARY
 };
 
 //!
@@ -71,8 +85,34 @@ static const QString TEXTFILE_OUTPUT = "TEXT";
 static const QString XMLFILE_OUTPUT = "XML";
 static const QString SIGNAL_OUTPUT = "SIGNAL";
 static const QString JSON_OUTPUT = "JSON";
-static const int NUM_OUTPUT = 5;
-static const QString outsbuf[NUM_OUTPUT] = { CONSOLE_OUTPUT, TEXTFILE_OUTPUT, XMLFILE_OUTPUT, SIGNAL_OUTPUT, JSON_OUTPUT };
+static const QString BINARY_OUTPUT = "BINARY";
+static const int NUM_OUTPUT = 6;
+static const QString outsbuf[NUM_OUTPUT] = { CONSOLE_OUTPUT, TEXTFILE_OUTPUT, XMLFILE_OUTPUT, SIGNAL_OUTPUT, JSON_OUTPUT, BINARY_OUTPUT };
+
+//!
+enum Compression
+{
+    NO_COMPRESSION, GZIP_COMPRESSION
+};
+
+//!
+static const QString NONE_COMPRESSION_STR = "NONE";
+static const QString GZIP_COMPRESSION_STR = "GZIP";
+static const QString ZLIB_COMPRESSION_STR = "ZLIB"; //! zlib deflate on a gzip file, same as GZIP
+static const int NUM_COMPRESSION = 2;
+static const QString compressionsbuf[NUM_COMPRESSION] = { NONE_COMPRESSION_STR, GZIP_COMPRESSION_STR };
+
+//!
+enum JsonFormat
+{
+    JSON_DOCUMENT, JSON_LINES
+};
+
+//!
+static const QString JSON_DOCUMENT_STR = "DOCUMENT";
+static const QString JSON_LINES_STR = "LINES";
+static const int NUM_JSON_FORMAT = 2;
+static const QString jsonformatsbuf[NUM_JSON_FORMAT] = { JSON_DOCUMENT_STR, JSON_LINES_STR };
 
 //!
 static const QString CH_LEVEL = "level";
@@ -83,6 +123,17 @@ static const QString CH_PATH = "path";
 static const QString CH_TIMESTAMP_FORMAT = "timestampFormat";
 static const QString CH_FILE_NAME = "fileName";
 static const QString CH_FILE_NAME_TIMESTAMP = "fileNameTimeStamp";
+static const QString CH_TIMESTAMP_UTC = "timestampUtc";
+static const QString CH_FLUSH_BUFFER_SIZE = "flushBufferSize";
+static const QString CH_FLUSH_INTERVAL = "flushInterval";
+static const QString CH_FLUSH_LEVEL = "flushLevel";
+static const QString CH_COMPRESS = "compress";
+static const QString CH_MAX_TOTAL_SIZE = "maxTotalSize";
+static const QString CH_MAX_FILES = "maxFiles";
+static const QString CH_MAX_AGE = "maxAge";
+static const QString CH_JSON_FORMAT = "jsonFormat";
+static const QString CH_ISOLATED_QUEUE = "isolatedQueue";
+static const QString CH_NATIVE_LINE_ENDINGS = "nativeLineEndings";
 static const QString CH_CONFIG_FILE_NAME = "qlogger.ini";
 
 //!
@@ -97,6 +148,39 @@ static const QString DEFAULT_LOG_PATH = ".";
 //! default size of the output log file = 1Mb
 static const qint64 DEFAULT_FILE_SIZE_MB = 1000000;
 
+//! a retention limit value for no limit, log files are kept forever
+static const int NO_RETENTION_LIMIT = 0;
+
+//! a flush policy value that lets the output use its own default
+static const int DEFAULT_FLUSH_POLICY = -1;
+
+//! file outputs flush after this many bytes by default = 64Kb
+static const qint64 DEFAULT_FLUSH_BUFFER_SIZE = 64000;
+
+//! file outputs flush logs waiting longer than this by default (milliseconds)
+static const int DEFAULT_FLUSH_INTERVAL_MS = 1000;
+
+//! a configuration file found empty or missing on a reload is read again after this (milliseconds)
+static const int CONFIG_REREAD_DELAY_MS = 100;
+
+//! how often the flush intervals are checked on synchronous mode (milliseconds)
+static const int FLUSH_TIMER_TICK_MS = 100;
+
+//! file outputs flush logs of this level right away by default
+static const Level DEFAULT_FLUSH_LEVEL = q1ERROR;
+
+//! file outputs hand their bytes to the file when this many are waiting, even before the flush = 64Kb
+static const int FILE_WRITE_BUFFER_SIZE = 65536;
+
+//! default number of records that can wait to be written on asynchronous mode
+static const int DEFAULT_QUEUE_CAPACITY = 8192;
+
+//! an isolated queue capacity for outputs written with the others, not on a thread of their own
+static const int NOT_ISOLATED = 0;
+
+//! added to the name of a compressed log file
+static const QString GZIP_FILE_SUFFIX = ".gz";
+
 //! will be used on the file name mask
 static const QString FILE_NAME_TIMESTAMP_FORMAT = "yyyyMMdd_hhmmss";
 
@@ -122,17 +206,16 @@ static const QString LEVEL_TAG = "<LEVEL>%1</LEVEL>";
 //! log_appname_logname_datetime.txt %1 = application name , %2 = owner , %3 = timestamp
 static const QString JSON_FILE_NAME_MASK = "log_%1_%2_%3.json";
 
-static const QString JSON_LOG_ENTRY = "{ "
-                                      "\"owner:\" \"%1\","
-                                      "\"level:\" \"%2\","
-                                      "\"message:\" \"%3\","
-                                      "\"dateTime:\" \"%4\","
-                                      "\"function:\" \"%5\","
-                                      "\"line:\" \"%6\" "
-                                      " }";
 static QString JSON_FILE_START = "{ \"logs\": [ ";
 static QString JSON_FILE_END = " ] }";
 
+//! log_appname_logname_datetime.ndjson %1 = application name , %2 = owner , %3 = timestamp, one json log per line
+static const QString JSON_LINES_FILE_NAME_MASK = "log_%1_%2_%3.ndjson";
+
+
+//! log_appname_logname_datetime.qlog %1 = application name , %2 = owner , %3 = timestamp, see binarylog.h
+static const QString BINARY_FILE_NAME_MASK = "log_%1_%2_%3.qlog";
+
 
 //! utility to convert the level enum to string
 inline static QString levelToString(const Level level)
@@ -149,6 +232,20 @@ inline static Level levelFromString(const QString level)
     return q1ERROR;
 }
 
+//! the time of a log, read once per log from the system clock, as nanoseconds since epoch,
+//! it is only converted to a date time when an output formats it
+inline static qint64 currentTimestamp()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+//! converts a log time to a date time, in UTC or in local time
+inline static QDateTime timestampToDateTime(const qint64 timestamp, const bool utc)
+{
+    return QDateTime::fromMSecsSinceEpoch(timestamp / 1000000, utc ? Qt::UTC : Qt::LocalTime);
+}
+
 //! convert to enum output type from string
 inline static OutputType ouputFromString(const QString out)
 {
@@ -158,7 +255,69 @@ inline static OutputType ouputFromString(const QString out)
     return CONSOLE;
 }
 
-//! do a plain text format based on the provided log format mask
+//! convert to enum compression from string, zlib is taken as gzip
+inline static Compression compressionFromString(const QString compression)
+{
+    if(0 == compression.trimmed().compare(ZLIB_COMPRESSION_STR, Qt::CaseInsensitive))
+        return GZIP_COMPRESSION;
+    for(int i = 0 ; i < NUM_COMPRESSION ; i++)
+        if(0 == compression.trimmed().compare(compressionsbuf[i], Qt::CaseInsensitive))
+                return static_cast<Compression>(i);
+    return NO_COMPRESSION;
+}
+
+//! convert to enum json format from string
+inline static JsonFormat jsonFormatFromString(const QString format)
+{
+    for(int i = 0 ; i < NUM_JSON_FORMAT ; i++)
+        if(0 == format.trimmed().compare(jsonformatsbuf[i], Qt::CaseInsensitive))
+                return static_cast<JsonFormat>(i);
+    return JSON_DOCUMENT;
+}
+
+//! reads a size of the configuration file, a plain number of bytes or with the units k, m, g (kb, mb, gb...),
+//! defaultSize when there is no number on the text
+inline static qint64 sizeFromString(const QString sizeStr, qint64 defaultSize)
+{
+    // in this option is possible to pass file sizes in plain int (number of bytes) or with the following options
+    // x Mb, xM, xm, xMB, x mb, xKB, xk, xK, xKb, xkb, xg, xG, xgb, xGb, xGB as x being the desired number.
+    QRegularExpression splitNumbers("^(\\d+)|\\s?([KMGkmg]{1,1}[Bb]{0,1})$");
+    //if fails to consume considers the default;
+    qint64 size = defaultSize;
+    QRegularExpressionMatchIterator matchIt = splitNumbers.globalMatch(sizeStr);
+    qint64 multiplier = 1;
+    bool isOk = false;
+    qint64 tempSize = 0;
+    while(matchIt.hasNext())
+    {
+        QRegularExpressionMatch match = matchIt.next();
+        QString token = match.captured();
+        tempSize = token.toLong(&isOk);
+        if(!isOk)
+        {
+            if(token.contains('k', Qt::CaseInsensitive))
+            {
+                multiplier = 1000; // 1kb
+            }
+            else if(token.contains('m', Qt::CaseInsensitive))
+            {
+                multiplier = 1000000; // 1mb
+            }
+            else if(token.contains('g', Qt::CaseInsensitive))
+            {
+                multiplier = 1000000000; // 1gb
+            }
+        }
+        else
+        {
+            size = tempSize;
+        }
+    }
+    return size * multiplier;
+}
+
+//! do a plain text format based on the provided log format mask, this compiles the mask on every call,
+//! outputs use the mask already compiled by their Configuration
 inline static QString formatLogText(const QString logFormatMask,
                                     const QString message,
                                     const QString owner,
@@ -167,13 +326,8 @@ inline static QString formatLogText(const QString logFormatMask,
                                     const QString functionName,
                                     const int lineNumber)
 {
-    QString text = QString(logFormatMask);
-    text = text.replace("%t", timestamp);
-    text = text.replace("%m", message);
-    text = text.replace("%l", lvl);
-    text = text.replace("%o", owner);
-    text = text.replace("%f", functionName);
-    text = text.replace("%n", QString::number(lineNumber));
+    QString text;
+    LogTextMask(logFormatMask).format(text, message, owner, lvl, timestamp, functionName, lineNumber);
     return text;
 }
 
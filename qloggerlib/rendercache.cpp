@@ -0,0 +1,109 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "rendercache.h"
+
+#include "configuration.h"
+#include "logger.h"
+#include "logrecord.h"
+#include "utf8.h"
+
+namespace qlogger
+{
+
+//! the reserved size of each rendering, a reserved buffer keeps its memory on resize(0)
+static const int RENDERING_RESERVE = 256;
+
+void renderText(QString &buffer, const LogRecord &record, Configuration &configuration)
+{
+    const LogTextMask &mask = configuration.getCompiledTextMask();
+    mask.format(buffer, record.message, record.logger->getOwner(), levelToString(record.level),
+                mask.usesTimestamp() ? configuration.getTimestampFormatter().format(record.timestamp) : QString(),
+                record.functionName, record.lineNumber);
+}
+
+void renderUtf8(QByteArray &buffer, const LogRecord &record, Configuration &configuration)
+{
+    const LogTextMask &mask = configuration.getCompiledTextMask();
+    mask.format(buffer, record.message, record.logger->getOwnerUtf8(), levelToUtf8(record.level),
+                mask.usesTimestamp() ? configuration.getTimestampFormatter().formatUtf8(record.timestamp) : QByteArray(),
+                record.functionName, record.lineNumber);
+}
+
+void RenderCache::clear()
+{
+    used = 0;
+}
+
+const QString &RenderCache::text(const LogRecord &record, Configuration &configuration)
+{
+    Rendering &rendering = find(configuration.getFormatId());
+    if(!rendering.hasText)
+    {
+        if(rendering.hasUtf8)
+            rendering.text += QString::fromUtf8(rendering.utf8);
+        else
+            renderText(rendering.text, record, configuration);
+        rendering.hasText = true;
+    }
+    return rendering.text;
+}
+
+const QByteArray &RenderCache::utf8(const LogRecord &record, Configuration &configuration)
+{
+    Rendering &rendering = find(configuration.getFormatId());
+    if(!rendering.hasUtf8)
+    {
+        if(rendering.hasText)
+            appendUtf8(rendering.utf8, rendering.text);
+        else
+            renderUtf8(rendering.utf8, record, configuration);
+        rendering.hasUtf8 = true;
+    }
+    return rendering.utf8;
+}
+
+RenderCache::Rendering &RenderCache::find(int formatId)
+{
+    for(int i = 0; i < used; ++i)
+    {
+        if(renderings[i].formatId == formatId)
+            return renderings[i];
+    }
+
+    if(used == renderings.size())
+    {
+        renderings.append(Rendering());
+        renderings.last().text.reserve(RENDERING_RESERVE);
+        renderings.last().utf8.reserve(RENDERING_RESERVE);
+    }
+
+    Rendering &rendering = renderings[used++];
+    rendering.formatId = formatId;
+    rendering.hasText = false;
+    rendering.hasUtf8 = false;
+    rendering.text.resize(0);
+    rendering.utf8.resize(0);
+    return rendering;
+}
+
+}
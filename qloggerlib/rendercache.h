@@ -0,0 +1,109 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+#include "qloggerlib_global.h"
+
+namespace qlogger
+{
+
+class Configuration;
+struct LogRecord;
+
+//!
+//! \brief renderText - appends the log formatted with the text mask of the configuration, without a line break
+//! \param buffer - where the text is appended
+//! \param record - the log to be formatted
+//! \param configuration - the text mask and timestamp format
+//!
+void renderText(QString &buffer, const LogRecord &record, Configuration &configuration);
+
+//!
+//! \brief renderUtf8 - same as renderText, the text encoded as UTF-8
+//! \param buffer - where the text is appended
+//! \param record - the log to be formatted
+//! \param configuration - the text mask and timestamp format
+//!
+void renderUtf8(QByteArray &buffer, const LogRecord &record, Configuration &configuration);
+
+//!
+//! \brief The RenderCache class - the texts of a log shared by the outputs of its owner. Outputs with the same
+//! text mask and timestamp format (the same Configuration::getFormatId) get the same text, it is formatted by the
+//! first one that asks and reused by the others. A text asked in the other encoding is converted, not formatted.
+//! qlogger clears it before each record, its buffers keep their memory between records.
+//!
+class RenderCache final
+{
+public:
+    RenderCache() = default;
+
+    //! forgets the texts of the previous record
+    void clear();
+
+    //!
+    //! \brief text - the log formatted with the configuration, without a line break
+    //! \param record - the record this cache was cleared for
+    //! \param configuration - the text mask and timestamp format
+    //!
+    const QString& text(const LogRecord &record, Configuration &configuration);
+
+    //!
+    //! \brief utf8 - the log formatted with the configuration as UTF-8, without a line break
+    //! \param record - the record this cache was cleared for
+    //! \param configuration - the text mask and timestamp format
+    //!
+    const QByteArray& utf8(const LogRecord &record, Configuration &configuration);
+
+private:
+    //! the texts of a format
+    struct Rendering
+    {
+        int formatId = -1;
+        bool hasText = false;
+        bool hasUtf8 = false;
+        QString text;
+        QByteArray utf8;
+    };
+
+    //! the rendering of the format, a new one if this record has none yet
+    Rendering& find(int formatId);
+
+private:
+    //!
+    //! \brief renderings - one for each format used since the last clear, kept allocated between records
+    //!
+    QVector<Rendering> renderings;
+
+    //!
+    //! \brief used - the renderings of the current record
+    //!
+    int used = 0;
+};
+
+}
+
+#endif // RENDERCACHE_H
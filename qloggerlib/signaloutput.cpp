@@ -20,6 +20,7 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 #include "signaloutput.h"
+#include "rendercache.h"
 
 #include <QDateTime>
 
@@ -31,15 +32,18 @@ SignalOutput::SignalOutput(Configuration *cfg) : Output(cfg)
 {
 }
 
-void SignalOutput::write(const QString message, const QString owner, const Level lvl,
-                         const QDateTime timestamp, const QString functionName,
-                         const int lineNumber)
+void SignalOutput::write(const LogRecord &record)
 {
 
-    QString logtext = formatLogText(configuration->getLogTextMask(),
-                                    message, owner, levelToString(lvl),
-                                    timestamp.toString(configuration->getTimestampFormat()),
-                                    functionName, lineNumber);
+    // outputs of the owner with the same format share the text formatted by the first one
+    if(record.rendered != nullptr)
+    {
+        emit qlogger(record.rendered->text(record, *configuration));
+        return;
+    }
+
+    QString logtext;
+    renderText(logtext, record, *configuration);
     emit qlogger(logtext);
 
 }
@@ -48,6 +52,10 @@ void SignalOutput::close()
 {
 }
 
+void SignalOutput::flush()
+{
+}
+
 
 
 }
@@ -51,21 +51,20 @@ public:
 public:
     //!
     //! \brief write
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \param record
     //!
-    void write(const QString message, const QString owner, const Level lvl,
-               const QDateTime timestamp, const QString functionName, const int lineNumber);
+    void write(const LogRecord &record);
 
     //!
     //! \brief close
     //!
     void close();
 
+    //!
+    //! \brief flush - nothing is buffered by signals
+    //!
+    void flush();
+
 signals:
     //!
     //! \brief qlogger - the signal emmited when 'write' is called
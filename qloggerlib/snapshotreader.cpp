@@ -0,0 +1,121 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "snapshotreader.h"
+
+#include <atomic>
+
+namespace qlogger
+{
+
+//! the epoch a thread reads on, there is one for each thread that ever read a snapshot
+struct ReaderSlot
+{
+    //! the epoch of the current read, 0 when the thread is not reading
+    std::atomic<quint64> epoch;
+    //! taken by a running thread, a slot is reused when its thread ends
+    std::atomic<bool> used;
+    //! the next slot, set before the slot is published and never changed
+    ReaderSlot *next;
+};
+
+//! the current epoch, it starts at 1 so 0 means not reading
+static std::atomic<quint64> globalEpoch(1);
+
+//! every slot ever created, they are never deleted
+static std::atomic<ReaderSlot*> slots(nullptr);
+
+//! takes a free slot or publishes a new one
+static ReaderSlot *acquireSlot()
+{
+    for(ReaderSlot *slot = slots.load(std::memory_order_acquire) ; slot != nullptr ; slot = slot->next)
+    {
+        bool expected = false;
+        if(!slot->used.load(std::memory_order_relaxed) && slot->used.compare_exchange_strong(expected, true))
+            return slot;
+    }
+
+    ReaderSlot *slot = new ReaderSlot;
+    slot->epoch.store(0, std::memory_order_relaxed);
+    slot->used.store(true, std::memory_order_relaxed);
+    slot->next = slots.load(std::memory_order_relaxed);
+    while(!slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed)) {}
+    return slot;
+}
+
+//! the slot of a thread and how deep its readers are nested, the slot is freed when the thread ends
+struct ThreadReader
+{
+    ~ThreadReader()
+    {
+        if(slot != nullptr)
+        {
+            slot->epoch.store(0);
+            slot->used.store(false, std::memory_order_release);
+            slot = nullptr;
+        }
+    }
+
+    ReaderSlot *slot = nullptr;
+    int depth = 0;
+};
+
+static thread_local ThreadReader threadReader;
+
+SnapshotReader::SnapshotReader()
+{
+    if(threadReader.depth++ > 0)
+        return;
+
+    if(threadReader.slot == nullptr)
+        threadReader.slot = acquireSlot();
+    threadReader.slot->epoch.store(globalEpoch.load());
+    // pairs with the fence of isReclaimable: the epoch store and the snapshot load that follows must not be
+    // reordered, so a writer either sees this epoch or this thread sees the new snapshot
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+SnapshotReader::~SnapshotReader()
+{
+    if(--threadReader.depth == 0)
+        threadReader.slot->epoch.store(0, std::memory_order_release);
+}
+
+quint64 SnapshotReader::retireEpoch()
+{
+    return globalEpoch.fetch_add(1);
+}
+
+bool SnapshotReader::isReclaimable(quint64 epoch)
+{
+    // the snapshot was replaced before, that store must be visible before the slots are read, see the reader
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for(ReaderSlot *slot = slots.load(std::memory_order_acquire) ; slot != nullptr ; slot = slot->next)
+    {
+        quint64 reading = slot->epoch.load();
+        if(reading != 0 && reading <= epoch)
+            return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef SNAPSHOTREADER_H
+#define SNAPSHOTREADER_H
+
+#include <QtGlobal>
+
+namespace qlogger
+{
+
+//!
+//! \brief The SnapshotReader class - epoch based reclamation of the snapshots qlogger reads without locks (the
+//! owner registry and the output lists). A reader marks its thread with the current epoch while it holds one,
+//! a writer that replaced a snapshot retires it on an epoch and deletes it once no thread reads on that epoch
+//! or an older one. Each thread has its own slot, so readers never write to a shared cache line.
+//!
+class SnapshotReader final
+{
+public:
+    //! marks the calling thread as reading, it may be nested
+    SnapshotReader();
+    //! the calling thread stops reading when the outermost reader ends
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader&) = delete;
+    SnapshotReader& operator=(const SnapshotReader&) = delete;
+
+    //!
+    //! \brief retireEpoch - starts a new epoch, call it after the snapshot was replaced
+    //! \return the epoch of the replaced snapshot, readers on it or before it may still hold it
+    //!
+    static quint64 retireEpoch();
+
+    //!
+    //! \brief isReclaimable - true if no thread is reading on the epoch or before it
+    //! \param epoch - the epoch returned by retireEpoch
+    //!
+    static bool isReclaimable(quint64 epoch);
+};
+
+}
+
+#endif // SNAPSHOTREADER_H
@@ -0,0 +1,402 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "textescape.h"
+
+#include "utf8.h"
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define QLOGGER_ESCAPE_SSE2
+#define QLOGGER_ESCAPE_AVX2
+#elif defined(_MSC_VER) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define QLOGGER_ESCAPE_SSE2
+#endif
+
+#ifdef QLOGGER_ESCAPE_SSE2
+#include <immintrin.h>
+#endif
+
+namespace qlogger
+{
+
+//! a scanner returns the first character that needs escaping, or end
+typedef const QChar *(*EscapeScanner)(const QChar *begin, const QChar *end);
+
+//! true for the characters that have to be escaped inside a json string
+static inline bool jsonNeedsEscape(ushort c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+//! true for the characters that have to be escaped inside xml text
+static inline bool xmlNeedsEscape(ushort c)
+{
+    return c == '<' || c == '>' || c == '&' || (c < 0x20 && c != '\t' && c != '\n' && c != '\r');
+}
+
+static const QChar *scanJsonScalar(const QChar *it, const QChar *end)
+{
+    for(; it != end; ++it)
+        if(jsonNeedsEscape(it->unicode()))
+            return it;
+    return end;
+}
+
+static const QChar *scanXmlScalar(const QChar *it, const QChar *end)
+{
+    for(; it != end; ++it)
+        if(xmlNeedsEscape(it->unicode()))
+            return it;
+    return end;
+}
+
+#ifdef QLOGGER_ESCAPE_SSE2
+
+//! the position of the first set 16 bits lane of a byte mask, movemask sets two bits per character
+static inline int firstLane(unsigned int mask)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index) / 2;
+#else
+    return __builtin_ctz(mask) / 2;
+#endif
+}
+
+//! 8 characters at once, c <= 0x1f is tested with a saturated subtraction as sse2 has no unsigned compare
+static const QChar *scanJsonSse2(const QChar *it, const QChar *end)
+{
+    const __m128i controlMax = _mm_set1_epi16(0x1f);
+    const __m128i quote = _mm_set1_epi16('"');
+    const __m128i backslash = _mm_set1_epi16('\\');
+    const __m128i zero = _mm_setzero_si128();
+    for(; end - it >= 8; it += 8)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        __m128i found = _mm_or_si128(_mm_cmpeq_epi16(_mm_subs_epu16(chars, controlMax), zero),
+                                     _mm_or_si128(_mm_cmpeq_epi16(chars, quote), _mm_cmpeq_epi16(chars, backslash)));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+        if(mask != 0)
+            return it + firstLane(mask);
+    }
+    return scanJsonScalar(it, end);
+}
+
+static const QChar *scanXmlSse2(const QChar *it, const QChar *end)
+{
+    const __m128i controlMax = _mm_set1_epi16(0x1f);
+    const __m128i less = _mm_set1_epi16('<');
+    const __m128i greater = _mm_set1_epi16('>');
+    const __m128i amp = _mm_set1_epi16('&');
+    const __m128i tab = _mm_set1_epi16('\t');
+    const __m128i lineFeed = _mm_set1_epi16('\n');
+    const __m128i carriageReturn = _mm_set1_epi16('\r');
+    const __m128i zero = _mm_setzero_si128();
+    for(; end - it >= 8; it += 8)
+    {
+        __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(it));
+        __m128i allowed = _mm_or_si128(_mm_cmpeq_epi16(chars, tab),
+                                       _mm_or_si128(_mm_cmpeq_epi16(chars, lineFeed), _mm_cmpeq_epi16(chars, carriageReturn)));
+        __m128i control = _mm_andnot_si128(allowed, _mm_cmpeq_epi16(_mm_subs_epu16(chars, controlMax), zero));
+        __m128i found = _mm_or_si128(control,
+                                     _mm_or_si128(_mm_cmpeq_epi16(chars, less),
+                                                  _mm_or_si128(_mm_cmpeq_epi16(chars, greater), _mm_cmpeq_epi16(chars, amp))));
+        unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+        if(mask != 0)
+            return it + firstLane(mask);
+    }
+    return scanXmlScalar(it, end);
+}
+
+#endif // QLOGGER_ESCAPE_SSE2
+
+#ifdef QLOGGER_ESCAPE_AVX2
+
+//! 16 characters at once, compiled for avx2 only here and used only when the cpu supports it
+__attribute__((target("avx2")))
+static const QChar *scanJsonAvx2(const QChar *it, const QChar *end)
+{
+    const __m256i controlMax = _mm256_set1_epi16(0x1f);
+    const __m256i quote = _mm256_set1_epi16('"');
+    const __m256i backslash = _mm256_set1_epi16('\\');
+    const __m256i zero = _mm256_setzero_si256();
+    for(; end - it >= 16; it += 16)
+    {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        __m256i found = _mm256_or_si256(_mm256_cmpeq_epi16(_mm256_subs_epu16(chars, controlMax), zero),
+                                        _mm256_or_si256(_mm256_cmpeq_epi16(chars, quote),
+                                                        _mm256_cmpeq_epi16(chars, backslash)));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+        if(mask != 0)
+            return it + firstLane(mask);
+    }
+    return scanJsonSse2(it, end);
+}
+
+__attribute__((target("avx2")))
+static const QChar *scanXmlAvx2(const QChar *it, const QChar *end)
+{
+    const __m256i controlMax = _mm256_set1_epi16(0x1f);
+    const __m256i less = _mm256_set1_epi16('<');
+    const __m256i greater = _mm256_set1_epi16('>');
+    const __m256i amp = _mm256_set1_epi16('&');
+    const __m256i tab = _mm256_set1_epi16('\t');
+    const __m256i lineFeed = _mm256_set1_epi16('\n');
+    const __m256i carriageReturn = _mm256_set1_epi16('\r');
+    const __m256i zero = _mm256_setzero_si256();
+    for(; end - it >= 16; it += 16)
+    {
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it));
+        __m256i allowed = _mm256_or_si256(_mm256_cmpeq_epi16(chars, tab),
+                                          _mm256_or_si256(_mm256_cmpeq_epi16(chars, lineFeed),
+                                                          _mm256_cmpeq_epi16(chars, carriageReturn)));
+        __m256i control = _mm256_andnot_si256(allowed, _mm256_cmpeq_epi16(_mm256_subs_epu16(chars, controlMax), zero));
+        __m256i found = _mm256_or_si256(control,
+                                        _mm256_or_si256(_mm256_cmpeq_epi16(chars, less),
+                                                        _mm256_or_si256(_mm256_cmpeq_epi16(chars, greater),
+                                                                        _mm256_cmpeq_epi16(chars, amp))));
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+        if(mask != 0)
+            return it + firstLane(mask);
+    }
+    return scanXmlSse2(it, end);
+}
+
+#endif // QLOGGER_ESCAPE_AVX2
+
+//!
+//! \brief The EscapeScanners struct - the best scanners for the cpu, picked once
+//!
+struct EscapeScanners
+{
+    EscapeScanner json;
+    EscapeScanner xml;
+    const char *name;
+
+    EscapeScanners() : json(scanJsonScalar), xml(scanXmlScalar), name("scalar")
+    {
+#ifdef QLOGGER_ESCAPE_SSE2
+        json = scanJsonSse2;
+        xml = scanXmlSse2;
+        name = "sse2";
+#endif
+#ifdef QLOGGER_ESCAPE_AVX2
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+        {
+            json = scanJsonAvx2;
+            xml = scanXmlAvx2;
+            name = "avx2";
+        }
+#endif
+    }
+};
+
+static const EscapeScanners &scanners()
+{
+    static const EscapeScanners selected;
+    return selected;
+}
+
+const QChar *findJsonEscape(const QChar *begin, const QChar *end)
+{
+    return scanners().json(begin, end);
+}
+
+const QChar *findXmlEscape(const QChar *begin, const QChar *end)
+{
+    return scanners().xml(begin, end);
+}
+
+const char *escapeKernel()
+{
+    return scanners().name;
+}
+
+//! appends ASCII text, the same bytes on both buffers
+static inline void appendAscii(QString &buffer, const char *text, int size)
+{
+    buffer += QLatin1String(text, size);
+}
+
+static inline void appendAscii(QByteArray &buffer, const char *text, int size)
+{
+    buffer.append(text, size);
+}
+
+template<typename Buffer, int N>
+static inline void appendAscii(Buffer &buffer, const char (&text)[N])
+{
+    appendAscii(buffer, text, N - 1);
+}
+
+//! appends the escape sequence of a json character that needs it, the sequences are all ASCII
+template<typename Buffer>
+static void appendJsonEscaped(Buffer &buffer, ushort c)
+{
+    static const char hex[] = "0123456789abcdef";
+    switch(c)
+    {
+        case '"': appendAscii(buffer, "\\\""); break;
+        case '\\': appendAscii(buffer, "\\\\"); break;
+        case '\n': appendAscii(buffer, "\\n"); break;
+        case '\r': appendAscii(buffer, "\\r"); break;
+        case '\t': appendAscii(buffer, "\\t"); break;
+        case '\b': appendAscii(buffer, "\\b"); break;
+        case '\f': appendAscii(buffer, "\\f"); break;
+        default:
+        {
+            const char unicode[] = { '\\', 'u', '0', '0', hex[(c >> 4) & 0xf], hex[c & 0xf] };
+            appendAscii(buffer, unicode, sizeof(unicode));
+        }
+    }
+}
+
+//! appends the entity of a xml character that needs it
+static void appendXmlEscaped(QString &buffer, ushort c)
+{
+    switch(c)
+    {
+        case '<': appendAscii(buffer, "&lt;"); break;
+        case '>': appendAscii(buffer, "&gt;"); break;
+        case '&': appendAscii(buffer, "&amp;"); break;
+        default: buffer += QChar(QChar::ReplacementCharacter); // not allowed on xml at all
+    }
+}
+
+static void appendXmlEscaped(QByteArray &buffer, ushort c)
+{
+    switch(c)
+    {
+        case '<': appendAscii(buffer, "&lt;"); break;
+        case '>': appendAscii(buffer, "&gt;"); break;
+        case '&': appendAscii(buffer, "&amp;"); break;
+        default: appendAscii(buffer, "\xef\xbf\xbd"); // U+FFFD encoded, not allowed on xml at all
+    }
+}
+
+//! appends a run of characters that need no escaping
+static inline void appendRun(QString &buffer, const QChar *run, int size)
+{
+    buffer.append(run, size);
+}
+
+static inline void appendRun(QByteArray &buffer, const QChar *run, int size)
+{
+    appendUtf8(buffer, run, size);
+}
+
+template<typename Buffer>
+static void appendJson(Buffer &buffer, const QString &text)
+{
+    EscapeScanner scan = scanners().json;
+    appendAscii(buffer, "\"");
+    const QChar *run = text.constData();
+    const QChar *end = run + text.size();
+    for(const QChar *it = scan(run, end); it != end; it = scan(run, end))
+    {
+        appendRun(buffer, run, static_cast<int>(it - run));
+        appendJsonEscaped(buffer, it->unicode());
+        run = it + 1;
+    }
+    appendRun(buffer, run, static_cast<int>(end - run));
+    appendAscii(buffer, "\"");
+}
+
+template<typename Buffer>
+static void appendXml(Buffer &buffer, const QString &text)
+{
+    EscapeScanner scan = scanners().xml;
+    const QChar *run = text.constData();
+    const QChar *end = run + text.size();
+    for(const QChar *it = scan(run, end); it != end; it = scan(run, end))
+    {
+        appendRun(buffer, run, static_cast<int>(it - run));
+        appendXmlEscaped(buffer, it->unicode());
+        run = it + 1;
+    }
+    appendRun(buffer, run, static_cast<int>(end - run));
+}
+
+void appendJsonString(QString &buffer, const QString &text)
+{
+    appendJson(buffer, text);
+}
+
+void appendJsonString(QByteArray &buffer, const QString &text)
+{
+    appendJson(buffer, text);
+}
+
+void appendXmlText(QString &buffer, const QString &text)
+{
+    appendXml(buffer, text);
+}
+
+void appendXmlText(QByteArray &buffer, const QString &text)
+{
+    appendXml(buffer, text);
+}
+
+//! true for the ASCII bytes a json string escapes, the bytes of multi byte UTF-8 characters never are
+static inline bool isJsonEscape(uchar c)
+{
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+//! true for the ASCII bytes xml text escapes
+static inline bool isXmlEscape(uchar c)
+{
+    return (c < 0x20 && c != '\t' && c != '\n' && c != '\r') || c == '<' || c == '>' || c == '&';
+}
+
+//! copies UTF-8 bytes, escaping the ASCII characters that need it, the texts are short (a timestamp)
+template<typename IsEscape, typename Escape>
+static void appendUtf8Escaped(QByteArray &buffer, const QByteArray &utf8, IsEscape isEscape, Escape escape)
+{
+    const char *run = utf8.constData();
+    const char *end = run + utf8.size();
+    for(const char *it = run; it != end; ++it)
+    {
+        if(!isEscape(static_cast<uchar>(*it)))
+            continue;
+        buffer.append(run, static_cast<int>(it - run));
+        escape(buffer, static_cast<uchar>(*it));
+        run = it + 1;
+    }
+    buffer.append(run, static_cast<int>(end - run));
+}
+
+void appendJsonUtf8(QByteArray &buffer, const QByteArray &utf8)
+{
+    appendAscii(buffer, "\"");
+    appendUtf8Escaped(buffer, utf8, isJsonEscape, [](QByteArray &out, ushort c) { appendJsonEscaped(out, c); });
+    appendAscii(buffer, "\"");
+}
+
+void appendXmlUtf8(QByteArray &buffer, const QByteArray &utf8)
+{
+    appendUtf8Escaped(buffer, utf8, isXmlEscape, [](QByteArray &out, ushort c) { appendXmlEscaped(out, c); });
+}
+
+}
@@ -0,0 +1,81 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef TEXTESCAPE_H
+#define TEXTESCAPE_H
+
+#include <QByteArray>
+#include <QString>
+
+namespace qlogger
+{
+
+//!
+//! \brief findJsonEscape - finds the first character that has to be escaped inside a json string
+//! (quotes, backslashes and control characters), scanning blocks of characters at once with SSE2 or AVX2
+//! when the cpu has them
+//! \return the character found, or end
+//!
+const QChar *findJsonEscape(const QChar *begin, const QChar *end);
+
+//!
+//! \brief findXmlEscape - finds the first character that has to be escaped inside xml text (< > & and the
+//! control characters xml does not allow), scanning blocks of characters at once like findJsonEscape
+//! \return the character found, or end
+//!
+const QChar *findXmlEscape(const QChar *begin, const QChar *end);
+
+//!
+//! \brief appendJsonString - appends the text as a quoted json string, escaping quotes, backslashes and
+//! control characters, the runs of characters that need no escaping are appended at once
+//! \param buffer - where the json string is appended
+//! \param text - the text to be escaped
+//!
+void appendJsonString(QString &buffer, const QString &text);
+
+//!
+//! \brief appendXmlText - appends the text escaped to be the content of an xml element, control characters
+//! not allowed on xml are replaced by U+FFFD
+//! \param buffer - where the text is appended
+//! \param text - the text to be escaped
+//!
+void appendXmlText(QString &buffer, const QString &text);
+
+//! appends the text as a quoted json string encoded as UTF-8, see appendJsonString
+void appendJsonString(QByteArray &buffer, const QString &text);
+
+//! appends the text escaped to be the content of an xml element encoded as UTF-8, see appendXmlText
+void appendXmlText(QByteArray &buffer, const QString &text);
+
+//! appends text already encoded as UTF-8 as a quoted json string, see appendJsonString
+void appendJsonUtf8(QByteArray &buffer, const QByteArray &utf8);
+
+//! appends text already encoded as UTF-8 escaped to be the content of an xml element, see appendXmlText
+void appendXmlUtf8(QByteArray &buffer, const QByteArray &utf8);
+
+//!
+//! \brief escapeKernel - the name of the scanner used by this cpu, "avx2", "sse2" or "scalar"
+//!
+const char *escapeKernel();
+
+}
+
+#endif // TEXTESCAPE_H
@@ -23,18 +23,215 @@
 #include "textoutput.h"
 
 #include "configuration.h"
+#include "filecompression.h"
+#include "fileretention.h"
+#include "rendercache.h"
+
+#include <atomic>
+#include <climits>
+
+#ifdef Q_OS_UNIX
+#include <errno.h>
+#include <sys/uio.h>
+#endif
 
 #include <QDateTime>
 #include <QDir>
-#include <QTextCodec>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QVarLengthArray>
 
 using namespace std;
 
 namespace qlogger
 {
 
-PlainTextOutput::PlainTextOutput(Configuration *conf) : ConsoleOutput(conf)
+//!
+//! \brief The PlainTextOutput::PreparedFile struct - the next log file, opened ahead by the worker and taken
+//! by the output on rotation. It is shared with the worker task so either side can go away first.
+//!
+struct PlainTextOutput::PreparedFile
+{
+    //! the opened file, nullptr while there is none
+    std::atomic<QFile*> file{nullptr};
+
+    //! removes a file that was opened but never used
+    ~PreparedFile()
+    {
+        discard(file.exchange(nullptr));
+    }
+
+    //! closes and removes an unused file
+    static void discard(QFile *unused)
+    {
+        if(unused == nullptr)
+            return;
+        unused->close();
+        unused->remove();
+        delete unused;
+    }
+};
+
+//!
+//! \brief openNewFile - opens a new log file named from the configuration, adding a _N suffix when a file
+//! with that name already exists so a log file is never truncated. The name is only taken by the open itself
+//! (NewOnly), so the worker preparing the next file and a rotation opening one can not get the same file
+//! \param fileNameMask - the file name mask of the configuration
+//! \param owner - the log owner of the configuration
+//! \param path - the file path of the configuration
+//! \param timestampText - the file name timestamp already formatted
+//! \param mode - the open mode of the file
+//! \return the new file, not open if the folder can not be written
+//!
+static QFile *openNewFile(const QString &fileNameMask, const QString &owner, const QString &path,
+                          const QString &timestampText, QIODevice::OpenMode mode)
+{
+    QString newFileName = fileNameMask.arg(QCoreApplication::applicationName(), owner, timestampText);
+    QFileInfo info(QDir(path).absoluteFilePath(newFileName));
+    QString base = info.dir().absoluteFilePath(info.completeBaseName());
+    QString suffix = info.suffix().isEmpty() ? QString() : QLatin1Char('.') + info.suffix();
+    QFile *file = new QFile(info.absoluteFilePath());
+    // a failed open of a name that exists is a name already taken, any other failure ends the search
+    for(int n = 1; !file->open(mode | QIODevice::NewOnly) && file->exists(); ++n)
+        file->setFileName(QString("%1_%2%3").arg(base).arg(n).arg(suffix));
+    return file;
+}
+
+//! matches the text a Qt date time format gives: numbers for the numeric fields, words for the day and month
+//! names and the quoted text and other characters as they are
+static QString timestampPattern(const QString &format)
+{
+    QString pattern;
+    for(int i = 0; i < format.size(); )
+    {
+        const QChar c = format.at(i);
+        if(c == QLatin1Char('\''))
+        {
+            int end = format.indexOf(QLatin1Char('\''), i + 1);
+            if(end < 0)
+                end = format.size();
+            pattern += QRegularExpression::escape(format.mid(i + 1, end - i - 1));
+            i = end + 1;
+            continue;
+        }
+
+        int run = 1;
+        while(i + run < format.size() && format.at(i + run) == c)
+            ++run;
+        switch(c.unicode())
+        {
+            case 'd': case 'M':
+                pattern += run >= 3 ? QStringLiteral("\\w+") : QStringLiteral("\\d+");
+                break;
+            case 'y': case 'h': case 'H': case 'm': case 's': case 'z':
+                pattern += QStringLiteral("\\d+");
+                break;
+            case 'a': case 'A':
+                // am/pm, written as ap, AP or a single a
+                if(i + run < format.size() && format.at(i + run).toLower() == QLatin1Char('p'))
+                    ++run;
+                pattern += QStringLiteral("[AaPp][Mm]");
+                break;
+            case 't':
+                pattern += QStringLiteral("\\S+");
+                break;
+            default:
+                pattern += QRegularExpression::escape(QString(run, c));
+                break;
+        }
+        i += run;
+    }
+    return pattern;
+}
+
+//!
+//! \brief retentionPattern - matches the names openNewFile gives to the files of a configuration, with the
+//! _N suffix and the .gz of a compressed file. The timestamp is matched field by field, so the files of an
+//! owner whose name starts with this owner name (app and app_net) never match
+//! \param configuration
+//! \return the anchored expression for the file names, without the folder
+//!
+static QRegularExpression retentionPattern(const Configuration &configuration)
+{
+    const QString marker(QChar(1));
+    QString name = configuration.getFileNameMask().arg(QCoreApplication::applicationName(),
+                                                       configuration.getLogOwner(),
+                                                       marker);
+    // the _N suffix goes before the extension
+    QString suffix;
+    const int at = name.indexOf(marker);
+    const int dot = name.lastIndexOf(QLatin1Char('.'));
+    if(dot > at)
+    {
+        suffix = name.mid(dot);
+        name.truncate(dot);
+    }
+
+    QString pattern;
+    if(at < 0)
+        pattern = QRegularExpression::escape(name);
+    else
+        pattern = QRegularExpression::escape(name.left(at))
+                + timestampPattern(configuration.getFileNameTimestampFormat())
+                + QRegularExpression::escape(name.mid(at + marker.size()));
+    return QRegularExpression(QStringLiteral("^") + pattern + QStringLiteral("(_\\d+)?")
+                              + QRegularExpression::escape(suffix)
+                              + QStringLiteral("(") + QRegularExpression::escape(GZIP_FILE_SUFFIX) + QStringLiteral(")?$"));
+}
+
+//! the files are written with a single call per buffer, QFile has no need to buffer them again.
+//! writeBuffer relies on it: the batches go straight to the file descriptor with writev, which is only safe
+//! while QFile holds no data of its own. QFile::pos() and size() do not follow those writes, the output
+//! counts its bytes instead (bytesWritten). Text mode only changes the line endings on windows, where
+//! writev is not used
+static const QIODevice::OpenMode LOG_FILE_OPEN_MODE = QIODevice::WriteOnly | QIODevice::Unbuffered;
+
+#ifdef Q_OS_UNIX
+#ifdef IOV_MAX
+static const int MAX_WRITE_SEGMENTS = IOV_MAX;
+#else
+static const int MAX_WRITE_SEGMENTS = 16; // the least POSIX allows
+#endif
+
+//!
+//! \brief writeVectors - writes the buffers in order with as few writev calls as possible, going on after a
+//! partial write
+//! \param fd - the file descriptor
+//! \param vectors - the buffers, changed while they are written
+//! \param count - the number of buffers
+//!
+static void writeVectors(int fd, struct iovec *vectors, int count)
+{
+    while(count > 0)
+    {
+        ssize_t written = ::writev(fd, vectors, count < MAX_WRITE_SEGMENTS ? count : MAX_WRITE_SEGMENTS);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+                continue;
+            return; // nothing more can be done from a log output
+        }
+
+        // skips the buffers written, the last one may be written only in part
+        for( ; count > 0 && static_cast<size_t>(written) >= vectors->iov_len; ++vectors, --count)
+            written -= static_cast<ssize_t>(vectors->iov_len);
+        if(count > 0)
+        {
+            vectors->iov_base = static_cast<char*>(vectors->iov_base) + written;
+            vectors->iov_len -= static_cast<size_t>(written);
+        }
+    }
+}
+#endif
+
+PlainTextOutput::PlainTextOutput(Configuration *conf) : ConsoleOutput(conf), bytesWritten(0),
+    preparedFile(new PreparedFile()), worker(FileWorker::acquire()), preparing(false)
 {
+    bufferedByDefault = true; // files are flushed by the flush policy, not on every log
+
+    // a reserved QByteArray keeps its memory on resize(0)
+    byteBuffer.reserve(256);
+    fileBuffer.reserve(FILE_WRITE_BUFFER_SIZE);
 }
 
 PlainTextOutput::~PlainTextOutput()
@@ -44,52 +241,327 @@ PlainTextOutput::~PlainTextOutput()
 
 void PlainTextOutput::createNextFile()
 {
-    // close any open i/o
-    close();
+    // the finished file is closed by the worker
+    retireFile();
+
+    // take the file opened ahead, if the worker did not open it yet open one here
+    QFile *prepared = preparedFile->file.exchange(nullptr);
+    preparing = false;
+    bytesWritten = 0;
+    if(prepared != nullptr)
+    {
+        outputFile = QSharedPointer<QFile>(prepared);
+    }
+    else
+    {
+        outputFile = QSharedPointer<QFile>(openNewFile(configuration->getFileNameMask(),
+                                                       configuration->getLogOwner(),
+                                                       configuration->getFilePath(),
+                                                       configuration->getFileNameTimestampFormatter().format(currentTimestamp()),
+                                                       fileOpenMode()));
+    }
+
+    if(outputFile->isOpen())
+        trackFile();
+}
+
+void PlainTextOutput::trackFile()
+{
+    if(!configuration->hasRetention())
+        return;
+
+    QFileInfo info(outputFile->fileName());
+    QString fileName = info.absoluteFilePath();
+    qint64 reservedSize = configuration->getFileMaxSizeInBytes();
+    QSharedPointer<FileRetention> files = retention;
+    if(files.isNull())
+    {
+        // the first file, the index is seeded with the files of this owner left on the folder
+        files = QSharedPointer<FileRetention>(new FileRetention(info.absolutePath(),
+                                                                retentionPattern(*configuration),
+                                                                configuration->getMaxTotalSize(),
+                                                                configuration->getMaxFiles(),
+                                                                configuration->getMaxAgeDays()));
+        retention = files;
+        worker->post([files, fileName, reservedSize]()
+        {
+            files->scan(fileName);
+            files->track(fileName, reservedSize);
+        });
+    }
+    else
+    {
+        worker->post([files, fileName, reservedSize]()
+        {
+            files->track(fileName, reservedSize);
+        });
+    }
+}
+
+void PlainTextOutput::prepareNextFile()
+{
+    preparing = true;
+    QSharedPointer<PreparedFile> slot = preparedFile;
+    const QIODevice::OpenMode mode = fileOpenMode();
+    // copied here, under the output mutex, a reload may change the configuration while the worker runs
+    const QString fileNameMask = configuration->getFileNameMask();
+    const QString owner = configuration->getLogOwner();
+    const QString path = configuration->getFilePath();
+    const QString timestampFormat = configuration->getFileNameTimestampFormat();
+    const bool utc = configuration->isTimestampUtc();
+    worker->post([slot, mode, fileNameMask, owner, path, timestampFormat, utc]()
+    {
+        // a formatter of its own, the configuration one belongs to the logging thread
+        TimestampFormatter formatter(timestampFormat, utc);
+        QFile *file = openNewFile(fileNameMask, owner, path, formatter.format(currentTimestamp()), mode);
+        if(!file->isOpen())
+        {
+            delete file; // the output opens it by itself on rotation
+            return;
+        }
+        file->moveToThread(nullptr); // used from now on by the logging threads
+        PreparedFile::discard(slot->file.exchange(file)); // replaces an older file never taken
+    });
+}
+
+void PlainTextOutput::retireFile()
+{
+    if(outputFile.isNull())
+        return;
+
+    // the bytes still buffered go with the file, the worker writes them before closing it
+    QByteArray pending;
+    pending.swap(fileBuffer);
+    fileBuffer.reserve(FILE_WRITE_BUFFER_SIZE);
+    QSharedPointer<QFile> finished = outputFile;
+    outputFile.clear();
+    Compression compression = configuration->getCompression();
+    QSharedPointer<FileRetention> files = retention;
+    worker->post([finished, pending, compression, files]()
+    {
+        if(!pending.isEmpty() && finished->isOpen())
+            finished->write(pending);
+        finished->close();
+
+        QString fileName = QFileInfo(finished->fileName()).absoluteFilePath();
+        QString finalName = fileName;
+        if(compression == GZIP_COMPRESSION && gzipFile(fileName, fileName + GZIP_FILE_SUFFIX))
+        {
+            QFile::remove(fileName);
+            finalName = fileName + GZIP_FILE_SUFFIX;
+        }
+
+        if(!files.isNull())
+            files->finished(fileName, finalName);
+    });
+}
+
+void PlainTextOutput::write(const LogRecord &record)
+{
+    if(record.level > configuration->getLogLevel()) // check level before writing
+        return;
 
-    // COMPOSE NEXT FILE NAME
-    QString newFileName = configuration->getFileNameMask().arg(QCoreApplication::applicationName(),
-                                                               configuration->getLogOwner(),
-                                                               QDateTime::currentDateTime().toString(configuration->getFileNameTimestampFormat()));
+    byteBuffer.resize(0); // keeps the capacity
+    formatEntry(byteBuffer, record);
+    writeEntry(byteBuffer, false);
+    written(record.level, byteBuffer.size(), record.timestamp);
+}
 
-    // TEXT FILE MODE
-    QDir dir(configuration->getFilePath());
-    QString myFile = dir.absoluteFilePath(newFileName);
-    outputFile.clear(); // release the memory from preovious files (if any)
-    outputFile = QSharedPointer<QFile>(new QFile(myFile));
+void PlainTextOutput::writeBatch(const LogRecord *records, int count)
+{
+    // the entries are referenced until the batch is written, each record has its own
+    for(int i = batchEntries.size(); i < count; ++i)
+    {
+        batchEntries.append(QByteArray());
+        batchEntries.last().reserve(256); // a reserved QByteArray keeps its memory on resize(0)
+    }
 
-    if(outputFile->open(QIODevice::WriteOnly | QIODevice::Text))
+    for(int i = 0; i < count; ++i)
     {
-        outputStream->setDevice((outputFile.get()));
+        const LogRecord &record = records[i];
+        if(record.level > configuration->getLogLevel()) // check level before writing
+            continue;
+
+        QByteArray &entry = batchEntries[i];
+        entry.resize(0);
+        formatEntry(entry, record);
+        writeEntry(entry, true);
+        written(record.level, entry.size(), record.timestamp);
     }
+    finishBatch();
+}
+
+void PlainTextOutput::formatEntry(QByteArray &buffer, const LogRecord &record)
+{
+    // outputs of the owner with the same format share the text formatted by the first one
+    if(record.rendered != nullptr)
+        buffer += record.rendered->utf8(record, *configuration);
+    else
+        renderUtf8(buffer, record, *configuration);
+    buffer += '\n';
+}
+
+const QByteArray &PlainTextOutput::fileStart() const
+{
+    static const QByteArray nothing;
+    return nothing;
+}
 
-    // enables the output to text mode and have correct line breaks
-    outputStream->device()->setTextModeEnabled(true);
-    outputStream->setCodec(QTextCodec::codecForName("UTF-8"));
+const QByteArray &PlainTextOutput::entrySeparator() const
+{
+    return fileStart();
 }
 
-void PlainTextOutput::write(const QString message,
-                            const QString owner,
-                            const Level lvl,
-                            const QDateTime timestamp,
-                            const QString functionName,
-                            const int lineNumber)
+const QByteArray &PlainTextOutput::fileEnd() const
 {
-    if(outputFile.isNull() //if there is no file
-            || !outputFile->isOpen() // or the file is not opened for writing
-            || (outputFile->size() > configuration->getFileMaxSizeInBytes())) // or the file is already at max size
+    return fileStart();
+}
+
+QIODevice::OpenMode PlainTextOutput::fileOpenMode() const
+{
+    return configuration->isNativeLineEndings() ? LOG_FILE_OPEN_MODE | QIODevice::Text : LOG_FILE_OPEN_MODE;
+}
+
+void PlainTextOutput::writeEntry(const QByteArray &entry, bool queued)
+{
+    const QByteArray &end = fileEnd();
+    const QByteArray &separator = entrySeparator();
+
+    // the separator before the log and the end of the file have to fit too
+    bool full = isFileOpen() && !fits(separator.size() + entry.size() + end.size());
+    if(full)
+    {
+        // end current file.
+        putBytes(end, queued);
+    }
+
+    if(full || !isFileOpen()) // no file yet or the log would go over the max size
     {
+        if(queued)
+            writeBuffer(); // the queued bytes belong to the finished file
         createNextFile(); // create a new file
+        putBytes(fileStart(), queued);
+    }
+    else // continues the file normally
+    {
+        putBytes(separator, queued);
+    }
+
+    putBytes(entry, queued);
+}
+
+bool PlainTextOutput::isFileOpen() const
+{
+    return !outputFile.isNull() && outputFile->isOpen();
+}
+
+bool PlainTextOutput::fits(qint64 size) const
+{
+    return bytesWritten == 0 || bytesWritten + size <= configuration->getFileMaxSizeInBytes();
+}
+
+void PlainTextOutput::writeBytes(const QByteArray &bytes)
+{
+    fileBuffer += bytes;
+    countWritten(bytes.size());
+
+    if(fileBuffer.size() >= FILE_WRITE_BUFFER_SIZE)
+        writeBuffer();
+}
+
+void PlainTextOutput::queueBytes(const QByteArray &bytes)
+{
+    if(bytes.isEmpty())
+        return;
+
+    Segment segment = { bytes.constData(), bytes.size() };
+    segments.append(segment);
+    countWritten(bytes.size());
+}
+
+void PlainTextOutput::putBytes(const QByteArray &bytes, bool queued)
+{
+    if(queued)
+        queueBytes(bytes);
+    else
+        writeBytes(bytes);
+}
+
+void PlainTextOutput::writeBuffer()
+{
+    if(fileBuffer.isEmpty() && segments.isEmpty())
+        return;
+
+    if(isFileOpen())
+    {
+#ifdef Q_OS_UNIX
+        if(!segments.isEmpty())
+        {
+            // the file is unbuffered (LOG_FILE_OPEN_MODE), its descriptor can be written directly
+            Q_ASSERT(outputFile->openMode() & QIODevice::Unbuffered);
+            QVarLengthArray<struct iovec, 256> vectors;
+            struct iovec vector;
+            if(!fileBuffer.isEmpty())
+            {
+                vector.iov_base = fileBuffer.data();
+                vector.iov_len = static_cast<size_t>(fileBuffer.size());
+                vectors.append(vector);
+            }
+            for(const Segment &segment : segments)
+            {
+                vector.iov_base = const_cast<char*>(segment.data);
+                vector.iov_len = static_cast<size_t>(segment.size);
+                vectors.append(vector);
+            }
+            writeVectors(outputFile->handle(), vectors.data(), vectors.size());
+        }
+        else
+#endif
+        {
+            for(const Segment &segment : segments)
+                fileBuffer.append(segment.data, segment.size);
+            outputFile->write(fileBuffer);
+        }
     }
+    fileBuffer.resize(0);
+    segments.resize(0);
+}
 
-    ConsoleOutput::write(message, owner, lvl, timestamp, functionName, lineNumber);
+void PlainTextOutput::finishBatch()
+{
+    qint64 queuedSize = fileBuffer.size();
+    for(const Segment &segment : segments)
+        queuedSize += segment.size;
+
+    if(queuedSize >= FILE_WRITE_BUFFER_SIZE)
+    {
+        writeBuffer();
+        return;
+    }
 
+    // a small batch waits on the buffer like single logs do
+    for(const Segment &segment : segments)
+        fileBuffer.append(segment.data, segment.size);
+    segments.resize(0);
+}
+
+void PlainTextOutput::countWritten(qint64 size)
+{
+    bytesWritten += size;
+
+    // half way to the max size, get the next file ready
+    if(!preparing && bytesWritten >= configuration->getFileMaxSizeInBytes() / 2)
+        prepareNextFile();
+}
+
+void PlainTextOutput::flush()
+{
+    writeBuffer();
 }
 
 void PlainTextOutput::close()
 {
-    if(!outputStream.isNull())
-        outputStream->flush();
+    writeBuffer();
 
     if(!outputFile.isNull())
         outputFile->close();
@@ -22,9 +22,13 @@
 #ifndef TEXTOUTPUT_H
 #define TEXTOUTPUT_H
 
+#include <QByteArray>
 #include <QFile>
+#include <QVector>
 
 #include "consoleoutput.h"
+#include "fileretention.h"
+#include "fileworker.h"
 
 using namespace std;
 
@@ -49,38 +53,186 @@ public:
 
     //!
     //! \brief write - this method is responsible for write the log text in the selected output
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \param record
     //!
-    virtual void write(const QString message,
-                       const QString owner,
-                       const Level lvl,
-                       const QDateTime timestamp,
-                       const QString functionName,
-                       const int lineNumber);
+    virtual void write(const LogRecord &record);
+
+    //!
+    //! \brief writeBatch - formats every log of the batch on a buffer of its own and hands them all to the file
+    //! with a single writev, the files are rotated between the logs
+    //! \param records
+    //! \param count
+    //!
+    virtual void writeBatch(const LogRecord *records, int count);
 
     //!
     //! \brief close
     //!
     virtual void close();
 
+    //! implemented from output, writes the buffered bytes to the file
+    virtual void flush();
+
 protected:
 
     //!
-    //! \brief createNextFile -  this method is called when a new file needs to be created due to size limitation
+    //! \brief createNextFile -  this method is called when a new file needs to be created due to size limitation,
+    //! it takes the file the worker opened ahead when there is one
     //!
     virtual void createNextFile();
 
+    //!
+    //! \brief formatEntry - appends a log to the buffer as it goes on the file, the text output formats it with
+    //! the text mask, one line per log
+    //! \param buffer
+    //! \param record
+    //!
+    virtual void formatEntry(QByteArray &buffer, const LogRecord &record);
+
+    //! the bytes that start every file, nothing for the text output
+    virtual const QByteArray &fileStart() const;
+
+    //! the bytes between two logs of the same file, nothing for the text output
+    virtual const QByteArray &entrySeparator() const;
+
+    //! the bytes that end every file, nothing for the text output
+    virtual const QByteArray &fileEnd() const;
+
+    //! the mode the files are opened with, in text mode unless the configuration turned native line endings off
+    virtual QIODevice::OpenMode fileOpenMode() const;
+
+    //!
+    //! \brief writeEntry - writes a formatted log with the file start, separator and end around it, rotating
+    //! the file when the log and the file end would go over the max size
+    //! \param entry - the formatted log
+    //! \param queued - true to only reference the bytes for the next writev, they must outlive it
+    //!
+    void writeEntry(const QByteArray &entry, bool queued);
+
+    //!
+    //! \brief isFileOpen - true if there is a file open to write the logs
+    //!
+    bool isFileOpen() const;
+
+    //!
+    //! \brief fits - checks if more bytes can be written to the current file without going over the max file size,
+    //! an empty file takes anything so a log bigger than the max size still gets written
+    //! \param size - the encoded size of the text to be written
+    //!
+    bool fits(qint64 size) const;
+
+    //!
+    //! \brief writeBytes - buffers the UTF-8 bytes for the current file and counts them, the buffer goes to
+    //! the file on flush or when it reaches FILE_WRITE_BUFFER_SIZE
+    //! \param bytes
+    //!
+    void writeBytes(const QByteArray &bytes);
+
+    //!
+    //! \brief queueBytes - references the bytes to be written by the next writeBuffer and counts them, the bytes
+    //! are not copied so they must not change until then
+    //! \param bytes
+    //!
+    void queueBytes(const QByteArray &bytes);
+
+    //! writes or queues the bytes, see writeBytes and queueBytes
+    void putBytes(const QByteArray &bytes, bool queued);
+
+    //!
+    //! \brief countWritten - adds bytes written to the current file, asking the next file when it is half full
+    //! \param size - the bytes written
+    //!
+    void countWritten(qint64 size);
+
 protected:
     //!
     //! \brief outputFile - the file handler to save on the output on the file system
     //!
     QSharedPointer<QFile> outputFile;
 
+    //!
+    //! \brief bytesWritten - bytes written to the current file, fileBuffer may still hold some of them
+    //!
+    qint64 bytesWritten;
+
+    //!
+    //! \brief byteBuffer - reused to format each log as UTF-8, keeps its memory between logs
+    //!
+    QByteArray byteBuffer;
+
+private:
+    //!
+    //! \brief prepareNextFile - asks the worker to open the next file ahead of the rotation
+    //!
+    void prepareNextFile();
+
+    //!
+    //! \brief writeBuffer - writes fileBuffer and the queued segments to the current file with a single call
+    //!
+    void writeBuffer();
+
+    //!
+    //! \brief finishBatch - writes the queued segments when they fill the buffer, copies them to fileBuffer
+    //! otherwise so a small batch still waits for the flush policy
+    //!
+    void finishBatch();
+
+    //!
+    //! \brief retireFile - hands the current file and its buffered bytes to the worker to be closed,
+    //! and compressed when the configuration asks for it
+    //!
+    void retireFile();
+
+    //!
+    //! \brief trackFile - adds the new file to the retention index, the worker removes the old files over the limits
+    //!
+    void trackFile();
+
+private:
+    struct PreparedFile;
+
+    //! bytes queued to be written by the next writeBuffer
+    struct Segment
+    {
+        const char *data;
+        int size;
+    };
+
+    //!
+    //! \brief preparedFile - the next file opened ahead by the worker
+    //!
+    QSharedPointer<PreparedFile> preparedFile;
+
+    //!
+    //! \brief retention - the index of the log files, only used by the worker, null when there are no limits
+    //!
+    QSharedPointer<FileRetention> retention;
+
+    //!
+    //! \brief worker - the thread that opens and closes the files off the logging path
+    //!
+    QSharedPointer<FileWorker> worker;
+
+    //!
+    //! \brief preparing - true when the next file was already asked to the worker
+    //!
+    bool preparing;
+
+    //!
+    //! \brief fileBuffer - the bytes waiting to be written to the current file
+    //!
+    QByteArray fileBuffer;
+
+    //!
+    //! \brief batchEntries - the formatted logs of the current batch, each one keeps its memory between batches
+    //!
+    QVector<QByteArray> batchEntries;
+
+    //!
+    //! \brief segments - the bytes queued after fileBuffer, written together with a single writev
+    //!
+    QVector<Segment> segments;
+
 
 };
 
@@ -0,0 +1,132 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "timestampformatter.h"
+
+#include <limits>
+
+#include "qloggerlib_global.h"
+
+namespace qlogger
+{
+
+//! a second no log will ever have, forces the first format
+static const qint64 NO_SECOND = std::numeric_limits<qint64>::min();
+
+//! marks where the milliseconds go on the text formatted by QDateTime
+static const QChar MILLI_MARKER = QChar(0x0001);
+
+TimestampFormatter::TimestampFormatter(const QString &format, bool utc) : utc(utc), cachedSecond(NO_SECOND)
+{
+    textUtf8.reserve(format.size() * 2); // a reserved QByteArray keeps its memory on resize(0)
+    bool quoted = false;
+    for(int i = 0 ; i < format.size() ; i++)
+    {
+        const QChar c = format.at(i);
+        if(c == QLatin1Char('\''))
+            quoted = !quoted;
+
+        if(quoted || c != QLatin1Char('z'))
+        {
+            secondFormat += c;
+            continue;
+        }
+
+        // a run of z is read as QDateTime does: zzz while there are three, then z
+        int run = 1;
+        while(i + run < format.size() && format.at(i + run) == QLatin1Char('z'))
+            run++;
+        i += run - 1;
+
+        for( ; run > 0 ; run -= milliDigits.last())
+        {
+            milliDigits.append(run >= 3 ? 3 : 1);
+            secondFormat += QLatin1Char('\'');
+            secondFormat += MILLI_MARKER;
+            secondFormat += QLatin1Char('\'');
+        }
+    }
+}
+
+int TimestampFormatter::updateSecond(qint64 timestamp)
+{
+    qint64 milliseconds = timestamp / 1000000;
+    qint64 second = milliseconds / 1000;
+    int millis = static_cast<int>(milliseconds % 1000);
+    if(millis < 0) // times before epoch
+    {
+        millis += 1000;
+        second--;
+    }
+
+    if(second != cachedSecond)
+    {
+        // the whole format goes to QDateTime, so symbols that depend on each other (h and AP) still work
+        parts = timestampToDateTime(second * 1000000000, utc).toString(secondFormat).split(MILLI_MARKER).toVector();
+        partsUtf8.resize(0);
+        for(const QString &part : parts)
+            partsUtf8.append(part.toUtf8());
+        cachedSecond = second;
+    }
+    return millis;
+}
+
+//! appends the milliseconds with the digits of the symbol, zzz always 3 digits and z without leading zeroes
+template<typename Text, typename Char>
+static void appendMillis(Text &text, int millis, int digits)
+{
+    if(digits == 3 || millis >= 100)
+        text += Char(static_cast<char>('0' + millis / 100));
+    if(digits == 3 || millis >= 10)
+        text += Char(static_cast<char>('0' + millis / 10 % 10));
+    text += Char(static_cast<char>('0' + millis % 10));
+}
+
+const QString &TimestampFormatter::format(qint64 timestamp)
+{
+    int millis = updateSecond(timestamp);
+
+    text.resize(0); // keeps the capacity
+    text += parts.at(0);
+    for(int i = 0 ; i < milliDigits.size() && i + 1 < parts.size() ; i++)
+    {
+        appendMillis<QString, QLatin1Char>(text, millis, milliDigits.at(i));
+        text += parts.at(i + 1);
+    }
+    return text;
+}
+
+const QByteArray &TimestampFormatter::formatUtf8(qint64 timestamp)
+{
+    int millis = updateSecond(timestamp);
+
+    textUtf8.resize(0); // keeps the capacity
+    textUtf8 += partsUtf8.at(0);
+    for(int i = 0 ; i < milliDigits.size() && i + 1 < partsUtf8.size() ; i++)
+    {
+        appendMillis<QByteArray, char>(textUtf8, millis, milliDigits.at(i));
+        textUtf8 += partsUtf8.at(i + 1);
+    }
+    return textUtf8;
+}
+
+}
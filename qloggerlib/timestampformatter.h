@@ -0,0 +1,93 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef TIMESTAMPFORMATTER_H
+#define TIMESTAMPFORMATTER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+namespace qlogger
+{
+
+//!
+//! \brief The TimestampFormatter class - formats log times with a Qt date time format compiled once.
+//! QDateTime formats the time only when the second changes, with the millisecond symbols (z, zzz)
+//! left as markers, so for each log the cached text is reused and only the milliseconds are written.
+//!
+class TimestampFormatter final
+{
+public:
+    //!
+    //! \brief TimestampFormatter - compiles the format
+    //! \param format - a Qt date time format
+    //! \param utc - true to write the time in UTC, false for local time
+    //!
+    explicit TimestampFormatter(const QString &format = QString(), bool utc = false);
+    ~TimestampFormatter() = default;
+
+    //!
+    //! \brief format - formats a log time
+    //! \param timestamp - nanoseconds since epoch
+    //! \return the formatted time, valid until the next call
+    //!
+    const QString& format(qint64 timestamp);
+
+    //!
+    //! \brief formatUtf8 - formats a log time encoded as UTF-8, the text of the second is encoded only once
+    //! \param timestamp - nanoseconds since epoch
+    //! \return the formatted time, valid until the next call
+    //!
+    const QByteArray& formatUtf8(qint64 timestamp);
+
+private:
+    //! the format given to QDateTime once per second, each millisecond symbol is replaced by a marker
+    QString secondFormat;
+
+    //! the millisecond symbols in order, 1 for z (no leading zeroes), 3 for zzz
+    QVector<int> milliDigits;
+
+    //! the text between the millisecond symbols, formatted for the cached second
+    QVector<QString> parts;
+
+    //! the parts encoded as UTF-8
+    QVector<QByteArray> partsUtf8;
+
+    //! true if the time is written in UTC
+    bool utc;
+
+    //! the second the cached parts were formatted for
+    qint64 cachedSecond;
+
+    //! the last formatted time
+    QString text;
+
+    //! the last formatted time encoded as UTF-8
+    QByteArray textUtf8;
+
+    //! formats the parts when the second changes, returns the milliseconds of the timestamp
+    int updateSecond(qint64 timestamp);
+};
+
+}
+
+#endif // TIMESTAMPFORMATTER_H
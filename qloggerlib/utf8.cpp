@@ -0,0 +1,95 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "utf8.h"
+
+namespace qlogger
+{
+
+void appendUtf8(QByteArray &buffer, const QChar *text, int size)
+{
+    // room for the worst case, 3 bytes per UTF-16 unit, the buffer is cut to the real size at the end
+    const int start = buffer.size();
+    buffer.resize(start + size * 3);
+    uchar *out = reinterpret_cast<uchar*>(buffer.data()) + start;
+
+    const ushort *it = reinterpret_cast<const ushort*>(text);
+    const ushort *end = it + size;
+    while(it != end)
+    {
+        ushort c = *it++;
+        if(c < 0x80)
+        {
+            *out++ = static_cast<uchar>(c);
+        }
+        else if(c < 0x800)
+        {
+            *out++ = static_cast<uchar>(0xc0 | (c >> 6));
+            *out++ = static_cast<uchar>(0x80 | (c & 0x3f));
+        }
+        else if(QChar::isHighSurrogate(c) && it != end && QChar::isLowSurrogate(*it))
+        {
+            uint codePoint = QChar::surrogateToUcs4(c, *it++);
+            *out++ = static_cast<uchar>(0xf0 | (codePoint >> 18));
+            *out++ = static_cast<uchar>(0x80 | ((codePoint >> 12) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | ((codePoint >> 6) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | (codePoint & 0x3f));
+        }
+        else if(QChar::isSurrogate(c))
+        {
+            *out++ = '?'; // a lone surrogate, written as QString::toUtf8 does
+        }
+        else
+        {
+            *out++ = static_cast<uchar>(0xe0 | (c >> 12));
+            *out++ = static_cast<uchar>(0x80 | ((c >> 6) & 0x3f));
+            *out++ = static_cast<uchar>(0x80 | (c & 0x3f));
+        }
+    }
+
+    buffer.resize(static_cast<int>(out - reinterpret_cast<uchar*>(buffer.data())));
+}
+
+void appendNumber(QByteArray &buffer, int value)
+{
+    char digits[12];
+    int pos = sizeof(digits);
+    unsigned int magnitude = value < 0 ? 0u - static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    do
+    {
+        digits[--pos] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+    while(magnitude != 0);
+    if(value < 0)
+        digits[--pos] = '-';
+    buffer.append(digits + pos, static_cast<int>(sizeof(digits)) - pos);
+}
+
+const QByteArray &levelToUtf8(const Level level)
+{
+    static const QByteArray names[NUM_LEVEL] = { FATAL_LEVEL.toUtf8(), ERROR_LEVEL.toUtf8(), WARN_LEVEL.toUtf8(),
+                                                 INFO_LEVEL.toUtf8(), DEBUG_LEVEL.toUtf8(), TRACE_LEVEL.toUtf8() };
+    return names[level];
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * QLogger - A tiny Qt logging framework.
+ *
+ * MIT License
+ * Copyright (c) 2013 sandro fadiga
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software
+ * is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies
+ * or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+#ifndef UTF8_H
+#define UTF8_H
+
+#include <QByteArray>
+#include <QString>
+
+#include "qloggerlib_global.h"
+
+namespace qlogger
+{
+
+//!
+//! \brief appendUtf8 - appends the text encoded as UTF-8 straight into the buffer, ASCII characters take a
+//! single test each, surrogate pairs become 4 bytes and lone surrogates '?' like QString::toUtf8
+//! \param buffer - where the text is appended, its capacity is kept between calls
+//! \param text - the UTF-16 characters
+//! \param size - the number of characters
+//!
+void appendUtf8(QByteArray &buffer, const QChar *text, int size);
+
+//! appends the whole string encoded as UTF-8
+inline void appendUtf8(QByteArray &buffer, const QString &text)
+{
+    appendUtf8(buffer, text.constData(), text.size());
+}
+
+//! appends the decimal number without creating a temporary string
+void appendNumber(QByteArray &buffer, int value);
+
+//! the level name encoded once as UTF-8
+const QByteArray &levelToUtf8(const Level level);
+
+}
+
+#endif // UTF8_H
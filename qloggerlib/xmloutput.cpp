@@ -23,14 +23,57 @@
 #include "xmloutput.h"
 #include "qloggerlib_global.h"
 #include "configuration.h"
+#include "logger.h"
+#include "textescape.h"
+#include "utf8.h"
 
 #include <QDir>
 #include <QDateTime>
-#include <QTextCodec>
+#include <QStringBuilder>
 
 namespace qlogger
 {
 
+//!
+//! \brief The XmlElement struct - the tags of an element of the log, split at the %1 and encoded once
+//!
+struct XmlElement
+{
+    explicit XmlElement(const QString &tag)
+    {
+        int at = tag.indexOf(QLatin1String("%1"));
+        open = tag.left(at).toUtf8();
+        close = (tag.mid(at + 2) + QLatin1Char('\n')).toUtf8();
+    }
+
+    QByteArray open;
+    QByteArray close;
+};
+
+//! appends an element of the log, the text escaped
+static void appendElement(QByteArray &buffer, const XmlElement &element, const QString &text)
+{
+    buffer += element.open;
+    appendXmlText(buffer, text);
+    buffer += element.close;
+}
+
+//! appends an element of the log, the text already UTF-8
+static void appendElement(QByteArray &buffer, const XmlElement &element, const QByteArray &utf8)
+{
+    buffer += element.open;
+    appendXmlUtf8(buffer, utf8);
+    buffer += element.close;
+}
+
+//! appends an element of the log with a number
+static void appendElement(QByteArray &buffer, const XmlElement &element, int number)
+{
+    buffer += element.open;
+    appendNumber(buffer, number);
+    buffer += element.close;
+}
+
 XmlOutput::XmlOutput(Configuration *conf) : PlainTextOutput(conf)
 {
     this->configuration->setFileNameMask(XML_FILE_NAME_MASK);
@@ -41,47 +84,42 @@ XmlOutput::~XmlOutput()
     if(!outputFile.isNull() && outputFile->isOpen())
     {
         // end current xml file.
-        *outputStream << ROOT_CLOSE_TAG << endl;
+        writeBytes(fileEnd());
     }
     PlainTextOutput::close();
 }
 
-void XmlOutput::write(const QString message,
-                      const QString owner,
-                      const Level lvl,
-                      const QDateTime timestamp,
-                      const QString functionName,
-                      const int lineNumber)
+void XmlOutput::formatEntry(QByteArray &buffer, const LogRecord &record)
 {
-    if(!outputFile.isNull()
-            && outputFile->isOpen()
-            && (outputFile->size() > configuration->getFileMaxSizeInBytes()))
-    {
-        // end current xml file.
-        *outputStream << ROOT_CLOSE_TAG << endl;
-    }
-
-    if(outputFile.isNull() //if there is no file
-            || !outputFile->isOpen() // or the file is not opened for writing
-            || (outputFile->size() > configuration->getFileMaxSizeInBytes())) // or the file is already at max size
-    {
-        createNextFile(); // create a new file
+    static const QByteArray logOpen = (LOG_TAG_OPEN + QLatin1Char('\n')).toUtf8();
+    static const QByteArray logClose = (LOG_TAG_CLOSE + QLatin1Char('\n')).toUtf8();
+    static const XmlElement dateTimeElement(DATE_TIME_TAG);
+    static const XmlElement levelElement(LEVEL_TAG);
+    static const XmlElement ownerElement(OWNER_TAG);
+    static const XmlElement messageElement(MESSAGE_TAG);
+    static const XmlElement lineElement(LINE_TAG);
+    static const XmlElement functionElement(FUNCTION_TAG);
 
-        // start the xml file.
-        *outputStream << XML_TAG << endl;
-        *outputStream << ROOT_OPEN_TAG << endl;
-
-    }
+    buffer += logOpen;
+    appendElement(buffer, dateTimeElement, configuration->getTimestampFormatter().formatUtf8(record.timestamp));
+    appendElement(buffer, levelElement, record.level);
+    appendElement(buffer, ownerElement, record.logger->getOwnerUtf8());
+    appendElement(buffer, messageElement, record.message);
+    appendElement(buffer, lineElement, record.lineNumber);
+    appendElement(buffer, functionElement, record.functionName);
+    buffer += logClose;
+}
 
-    *outputStream << LOG_TAG_OPEN << endl;
-    *outputStream << DATE_TIME_TAG.arg(timestamp.toString(configuration->getTimestampFormat())) << endl;
-    *outputStream << LEVEL_TAG.arg(lvl) << endl;
-    *outputStream << OWNER_TAG.arg(owner) << endl;
-    *outputStream << MESSAGE_TAG.arg(message) << endl;
-    *outputStream << LINE_TAG.arg(lineNumber) << endl;
-    *outputStream << FUNCTION_TAG.arg(functionName) << endl;
-    *outputStream << LOG_TAG_CLOSE << endl;
+const QByteArray &XmlOutput::fileStart() const
+{
+    static const QByteArray start = (XML_TAG % QLatin1Char('\n') % ROOT_OPEN_TAG % QLatin1Char('\n')).toUtf8();
+    return start;
+}
 
+const QByteArray &XmlOutput::fileEnd() const
+{
+    static const QByteArray end = (ROOT_CLOSE_TAG + QLatin1Char('\n')).toUtf8();
+    return end;
 }
 
 }
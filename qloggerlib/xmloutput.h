@@ -46,21 +46,19 @@ public:
 
 
 
+protected:
     //!
-    //! \brief write -  reimplemented to write a xml on the file
-    //! \param message
-    //! \param owner
-    //! \param lvl
-    //! \param timestamp
-    //! \param functionName
-    //! \param lineNumber
+    //! \brief formatEntry - reimplemented to format the log as a xml element
+    //! \param buffer
+    //! \param record
     //!
-    virtual void write(const QString message,
-                       const QString owner,
-                       const Level lvl,
-                       const QDateTime timestamp,
-                       const QString functionName,
-                       const int lineNumber);
+    void formatEntry(QByteArray &buffer, const LogRecord &record);
+
+    //! the xml declaration and the root open tag
+    const QByteArray &fileStart() const;
+
+    //! the root close tag
+    const QByteArray &fileEnd() const;
 
 };
 
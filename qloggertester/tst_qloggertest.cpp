@@ -19,17 +19,25 @@
  * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
+#include <algorithm>
+#include <atomic>
+
 #include <QtTest>
 #include <QCoreApplication>
 
 #include <QTime>
 #include <QRunnable>
+#include <QSemaphore>
 #include <QThreadPool>
 #include <QDebug>
 #include <QString>
 
 // add necessary includes here
 #include "qlogger.h"
+#include "filecompression.h"
+#include "binarylog.h"
+#include "textescape.h"
+#include "utf8.h"
 
 using namespace qlogger;
 
@@ -53,6 +61,69 @@ class LoggerB : public QRunnable
     }
 };
 
+//! an output stuck on its io, as a file on a network drive that stopped answering
+class SlowOutput : public Output
+{
+public:
+    explicit SlowOutput(Configuration *conf, unsigned long delay = 20) : Output(conf), count(0), delay(delay) {}
+    void write(const LogRecord &)
+    {
+        if(delay > 0)
+            QThread::msleep(delay);
+        count++;
+    }
+    void close() {}
+    void flush() {}
+
+    std::atomic<int> count;
+    const unsigned long delay;
+};
+
+//! an output whose writes wait for the test to let them go
+class GatedOutput : public Output
+{
+public:
+    explicit GatedOutput(Configuration *conf) : Output(conf), count(0) {}
+    void write(const LogRecord &)
+    {
+        entered.release();
+        gate.acquire();
+        count++;
+    }
+    void close() {}
+    void flush() {}
+
+    QSemaphore entered;
+    QSemaphore gate;
+    std::atomic<int> count;
+};
+
+//! logs to the owner with a slow output
+class SlowOwnerLogger : public QRunnable
+{
+    void run()
+    {
+        for(int i = 0 ; i < 50 ; i++)
+            QLOG_INFO("a log for the slow owner", "lockslow");
+    }
+};
+
+//! logs numbered records, so the order each thread logged in can be checked
+class NumberedLogger : public QRunnable
+{
+public:
+    NumberedLogger(int thread, int count) : thread(thread), count(count) {}
+    void run()
+    {
+        for(int i = 0 ; i < count ; i++)
+            QLOGF_INFO("asyncorder", "t:%1 n:%2", thread, i);
+    }
+
+private:
+    int thread;
+    int count;
+};
+
 //!
 //! \brief The QLoggerTest class - this is a broad test class for the qlogger project
 //! it do some unit testing and also application testing
@@ -81,7 +152,30 @@ private slots:
     void test_caseConfigurationLevelToString();
     void test_caseOutputFromString();
     void test_caseConsoleFormatString();
+    void test_caseCompiledTextMask();
+    void test_caseTimestamp();
+    void test_caseTimestampFormatter();
     void test_caseQLoggerAdd();
+    void test_caseLazyMessage();
+    void test_caseLoggerHandle();
+    void test_caseDeferredFormat();
+    void test_caseCallSite();
+    void test_caseSharedRendering();
+    void test_caseFlushPolicy();
+    void test_caseFileRotation();
+    void test_caseGzipFile();
+    void test_caseFileRetention();
+    void test_caseBinaryOutput();
+    void test_caseJSONLines();
+    void test_caseBatchWrite();
+    void test_caseIsolatedOutput();
+    void test_caseOutputLocking();
+    void test_caseSnapshotReader();
+    void test_caseConfigurationReload();
+    void test_caseTextEscape();
+    void test_caseEscapeBenchmark_data();
+    void test_caseEscapeBenchmark();
+    void test_caseUtf8Pipeline();
     void test_caseHeavyLoadFileTest();
     void test_caseConfigFromFile();
     void test_caseSameLoggerMultiLevels();
@@ -90,6 +184,8 @@ private slots:
     void test_caseLogSignals();
     void test_caseJSONOutput();
     void test_caseThreadHeavyLoadTest();
+    void test_caseAsyncThreadHeavyLoadTest();
+    void test_caseAsyncThreadOrder();
 };
 
 void QLoggerTest::signalSlotPrinter(QString msg)
@@ -196,13 +292,68 @@ void QLoggerTest::test_caseConsoleFormatString()
     Configuration *cf = new Configuration("owner", Level::q1ERROR);
     ConsoleOutput *co = new ConsoleOutput(cf);
 
-    co->write("test case on console", "owner", q2WARN, QDateTime::currentDateTime(), "test_caseConsoleFormatString", 123);
+    LogRecord record;
+    record.level = q2WARN;
+    record.timestamp = currentTimestamp();
+    record.logger = QLogger::getLogger("owner");
+    record.functionName = "test_caseConsoleFormatString";
+    record.lineNumber = 123;
+    record.message = "test case on console";
+    co->write(record);
 
     QSharedPointer<Configuration> cfg = co->getConfiguration();
 
     QVERIFY2(cfg.get() == cf, "test same reference");
 }
 
+void QLoggerTest::test_caseCompiledTextMask()
+{
+    LogTextMask mask("%t [%o] <%l> (%f) {line:%n} - %m %x");
+    QString text;
+    mask.format(text, "a message with %l inside", "owner", WARN_LEVEL, "now", "function", -42);
+    QVERIFY2(text == "now [owner] <WARN> (function) {line:-42} - a message with %l inside %x",
+             "symbols replaced in one pass, the message is not scanned");
+    QVERIFY2(mask.usesTimestamp(), "the mask has %t");
+    QVERIFY2(!LogTextMask("%m").usesTimestamp(), "the mask has no %t");
+}
+
+void QLoggerTest::test_caseTimestamp()
+{
+    qint64 before = QDateTime::currentMSecsSinceEpoch();
+    qint64 now = currentTimestamp();
+    QVERIFY2(now / 1000000 >= before, "the log time is in nanoseconds since epoch");
+
+    QDateTime utc = timestampToDateTime(now, true);
+    QDateTime local = timestampToDateTime(now, false);
+    QVERIFY2(utc.timeSpec() == Qt::UTC, "converted to UTC");
+    QVERIFY2(utc.toMSecsSinceEpoch() == local.toMSecsSinceEpoch(), "UTC and local time are the same instant");
+}
+
+void QLoggerTest::test_caseTimestampFormatter()
+{
+    const QStringList formats = { DEFAULT_TIMESTAMP_FORMAT, FILE_NAME_TIMESTAMP_FORMAT, "hh:mm:ss.zzz",
+                                  "h:mm:ss.z AP", "'quoted z' yyyy zzzz" };
+    const qint64 base = Q_INT64_C(1540000000000000000); // nanoseconds since epoch
+    const qint64 offsets[] = { 0, 7000000, 45000000, 999000000, 1000000000, 61123000000 };
+    for(const QString &format : formats)
+    {
+        TimestampFormatter formatter(format, false);
+        for(qint64 offset : offsets)
+        {
+            qint64 timestamp = base + offset;
+            QString expected = QDateTime::fromMSecsSinceEpoch(timestamp / 1000000).toString(format);
+            QVERIFY2(formatter.format(timestamp) == expected, qPrintable(format));
+        }
+    }
+
+    // the configuration compiles the format it was built with
+    Configuration cfg("formatter", q5TRACE, DEFAULT_TEXT_MASK, "yyyy hh:mm:ss.zzz");
+    const QString formatted = cfg.getTimestampFormatter().format(base);
+    QVERIFY2(!formatted.isEmpty(), "timestamp formatted by the configuration");
+    QVERIFY2(formatted == QDateTime::fromMSecsSinceEpoch(base / 1000000).toString("yyyy hh:mm:ss.zzz"),
+             "configuration timestamp format");
+}
+
 void QLoggerTest::test_caseQuickLogger()
 {
     QLOG_FATAL("this is quick logged using the default root logger");
@@ -231,6 +382,643 @@ void QLoggerTest::test_caseQLoggerAdd()
     QLOG_ERROR("end of test_caseQLoggerAdd");
 }
 
+void QLoggerTest::test_caseLazyMessage()
+{
+    int evaluated = 0;
+    auto message = [&evaluated]() { evaluated++; return QString("lazy message"); };
+
+    QLogger::addLogger("lazy", q2WARN, CONSOLE);
+    QVERIFY2(!QLogger::isEnabled(q5TRACE, "lazy"), "trace is not enabled for lazy");
+    QVERIFY2(QLogger::isEnabled(q2WARN, "lazy"), "warn is enabled for lazy");
+
+    QLOG_TRACE(message(), "lazy");
+    QVERIFY2(evaluated == 0, "a disabled level must not evaluate the message");
+
+    QLOG_WARN(message(), "lazy");
+    QVERIFY2(evaluated == 1, "an enabled level evaluates the message once");
+
+    QVERIFY2(!QLogger::isEnabled(q0FATAL, "lazyghost"), "no level is enabled for an unknown owner");
+    QLOG_FATAL(message(), "lazyghost");
+    QVERIFY2(evaluated == 1, "an unknown owner does not evaluate the message");
+    QVERIFY2(QLogger::findLogger("lazyghost") == nullptr, "checking an unknown owner does not add it");
+
+    // the same call site logs once the owner has an output
+    for (int i = 0; i != 2; ++i)
+    {
+        if (i == 1)
+            QLogger::addLogger("lazyghost", q2WARN, CONSOLE);
+        QLOG_WARN(message(), "lazyghost");
+    }
+    QVERIFY2(evaluated == 2, "the call site found the owner added after its first log");
+}
+
+void QLoggerTest::test_caseLoggerHandle()
+{
+    Logger *handle = QLogger::getLogger("handle");
+    QVERIFY2(handle != nullptr, "a handle is returned even before the owner has outputs");
+    QVERIFY2(!handle->isEnabled(q0FATAL), "no output, no level enabled");
+
+    QLogger::addLogger("handle", q3INFO, CONSOLE);
+    QVERIFY2(handle == QLogger::getLogger("handle"), "the owner always has the same handle");
+    QVERIFY2(handle->isEnabled(q3INFO), "info is enabled after the output was added");
+
+    handle->info("logged through the handle");
+    QLOGL_ERROR(handle, "logged through the handle macro");
+}
+
+void QLoggerTest::test_caseDeferredFormat()
+{
+    LogArguments arguments;
+    arguments.append(toLogArgument(42));
+    arguments.append(toLogArgument(QString("text")));
+    arguments.append(toLogArgument(2.5));
+    arguments.append(toLogArgument(q3INFO));
+    arguments.append(toLogArgument(QByteArray("bytes")));
+    QString text = formatLogArguments("%1 %2 %3 %4 %5 %6 %%1", arguments);
+    QVERIFY2(text == "42 text 2.5 3 bytes %6 %42", "arguments replaced in a single pass");
+
+    QLogger::addLogger("deferred", q3INFO, CONSOLE);
+    QLOGF_INFO("deferred", "a deferred log n:%1 of %2 !", 1, 10);
+    QLOGF_DEBUG("deferred", "not logged, the arguments are not even copied n:%1", 2);
+}
+
+void QLoggerTest::test_caseCallSite()
+{
+    static CallSite site(__FUNCTION__, __FILE__, __LINE__, q2WARN);
+    QVERIFY2(site.functionName() == QString(__FUNCTION__), "function name of the site");
+    QVERIFY2(&site.functionName() == &site.functionName(), "function name built once");
+    QVERIFY2(site.owner.resolve("callsite") == QLogger::getLogger("callsite"), "owner cached on the site");
+
+    LogRecord record;
+    record.site = &site;
+    record.resolve();
+    QVERIFY2(record.functionName == site.functionName() && record.lineNumber == site.line,
+             "function and line taken from the site when the log is written");
+}
+
+void QLoggerTest::test_caseSharedRendering()
+{
+    Configuration first("render", q5TRACE, "%t [%l] <%o> %m");
+    Configuration second("render", q3INFO, "%t [%l] <%o> %m");
+    Configuration other("render", q5TRACE, "%l %m");
+    QVERIFY2(first.getFormatId() == second.getFormatId(), "same mask and timestamp is the same format");
+    QVERIFY2(first.getFormatId() != other.getFormatId(), "another mask is another format");
+    second.setTimestampUtc(true);
+    QVERIFY2(first.getFormatId() != second.getFormatId(), "utc times are another format");
+    second.setTimestampUtc(false);
+
+    LogRecord record;
+    record.level = q2WARN;
+    record.timestamp = currentTimestamp();
+    record.logger = QLogger::getLogger("render");
+    record.message = "a text formatted once";
+
+    RenderCache cache;
+    cache.clear();
+    const QString &text = cache.text(record, first);
+    QString expected;
+    renderText(expected, record, first);
+    QVERIFY2(text == expected, "the shared text is the text of the output");
+    QVERIFY2(&cache.text(record, second) == &text, "the same format is formatted once");
+    QVERIFY2(cache.utf8(record, second) == text.toUtf8(), "the UTF-8 text is the same text");
+
+    QString otherText;
+    renderText(otherText, record, other);
+    QVERIFY2(cache.text(record, other) == otherText, "another format has its own text");
+
+    record.message = "the next record";
+    cache.clear();
+    QVERIFY2(cache.text(record, first).endsWith(record.message), "clear forgets the previous record");
+}
+
+void QLoggerTest::test_caseFlushPolicy()
+{
+    Configuration *cf = new Configuration("flush", q5TRACE);
+    QVERIFY2(cf->getFlushBufferSize() == DEFAULT_FLUSH_POLICY, "the output default buffer size is used");
+    QVERIFY2(cf->getFlushInterval() == DEFAULT_FLUSH_POLICY, "the output default interval is used");
+    QVERIFY2(cf->getFlushLevel() == DEFAULT_FLUSH_POLICY, "the output default flush level is used");
+
+    cf->setFlushBufferSize(1000000);
+    cf->setFlushInterval(0);
+    cf->setFlushLevel(q0FATAL);
+    QVERIFY2(cf->getFlushBufferSize() == 1000000, "buffer size changed");
+    QVERIFY2(cf->getFlushInterval() == 0, "interval flush disabled");
+    QVERIFY2(cf->getFlushLevel() == q0FATAL, "only fatal logs are flushed right away");
+
+    QLogger::addLogger(cf, TEXTFILE);
+    for (int i = 0; i != 100; ++i)
+        QLOGF_TRACE("flush", "buffered until the flush n:%1", i);
+    QLogger::flush();
+
+    // a quiet output is flushed by time without another log
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_flush"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "flush test folder created");
+    Configuration *quiet = new Configuration("quietflush", q5TRACE, "%l %m", DEFAULT_TIMESTAMP_FORMAT,
+                                             "quiet_%2_%3.log", "yyyyMMdd_hhmmss", dir.absolutePath());
+    quiet->setFlushInterval(200);
+    QLogger::addLogger(quiet, TEXTFILE);
+    QLOG_WARN("the only log of the owner", "quietflush");
+    auto writtenSize = [&dir](const QString &prefix)
+    {
+        QFileInfoList files = dir.entryInfoList(QStringList() << prefix + "*", QDir::Files);
+        return files.isEmpty() ? 0 : files.first().size();
+    };
+    QTRY_VERIFY2(writtenSize("quiet_") > 0, "the buffered log is written after the flush interval");
+
+    // errors are flushed right away by default, a crash after them does not lose them
+    Configuration *errors = new Configuration("errorflush", q5TRACE, "%l %m", DEFAULT_TIMESTAMP_FORMAT,
+                                              "errors_%2_%3.log", "yyyyMMdd_hhmmss", dir.absolutePath());
+    QLogger::addLogger(errors, TEXTFILE);
+    QLOG_ERROR("an error written without waiting", "errorflush");
+    QVERIFY2(writtenSize("errors_") > 0, "the error log is written right away");
+
+    QVERIFY2(sizeFromString("100k", 0) == 100000, "size in kb");
+    QVERIFY2(sizeFromString("10 MB", 0) == 10000000, "size in mb");
+    QVERIFY2(sizeFromString("", -1) == -1, "default size");
+}
+
+void QLoggerTest::test_caseFileRotation()
+{
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_rotation"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "rotation test folder created");
+
+    const qint64 maxSize = 2000;
+    Configuration* cfg = new Configuration("rotation", q5TRACE, "%l %m", DEFAULT_TIMESTAMP_FORMAT,
+                                           "rotation_%2_%3.log", "yyyyMMdd_hhmmss", dir.absolutePath(), maxSize);
+    QLogger::addLogger(cfg, TEXTFILE);
+
+    const int count = 200;
+    for (int i = 0; i != count; ++i)
+        QLOGF_TRACE("rotation", "a log that fills the rotation files n:%1", i);
+    QLogger::flush();
+
+    QFileInfoList files = dir.entryInfoList(QDir::Files);
+    QVERIFY2(files.size() > 1, "files rotated on the same second are not overwritten");
+    int written = 0;
+    for (const QFileInfo &file : files)
+    {
+        QVERIFY2(file.size() <= maxSize, "no file goes over the max size");
+        QFile log(file.absoluteFilePath());
+        QVERIFY2(log.open(QIODevice::ReadOnly | QIODevice::Text), "rotation file opened");
+        written += log.readAll().count("a log that fills the rotation files");
+    }
+    QVERIFY2(written == count, "no file was opened twice, every log is in one of them");
+}
+
+void QLoggerTest::test_caseGzipFile()
+{
+    QVERIFY2(crc32(0, QByteArray("123456789")) == 0xcbf43926u, "gzip crc32 check value");
+    QVERIFY2(compressionFromString("gzip") == GZIP_COMPRESSION, "gzip compression from string");
+    QVERIFY2(compressionFromString("zlib") == GZIP_COMPRESSION, "zlib is written as gzip");
+    QVERIFY2(compressionFromString("") == NO_COMPRESSION, "no compression by default");
+
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_gzip"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "gzip test folder created");
+
+    QByteArray text;
+    for (int i = 0; i != 50000; ++i)
+        text += QString("a log line to be compressed n:%1\n").arg(i).toUtf8();
+    QFile source(dir.absoluteFilePath("source.log"));
+    QVERIFY2(source.open(QIODevice::WriteOnly) && source.write(text) == text.size(), "source file written");
+    source.close();
+
+    QString target = dir.absoluteFilePath("source.log.gz");
+    QVERIFY2(gzipFile(source.fileName(), target), "file compressed");
+    QFile gz(target);
+    QVERIFY2(gz.open(QIODevice::ReadOnly), "gzip file created");
+    QByteArray header = gz.read(2);
+    QVERIFY2(header == QByteArray("\x1f\x8b"), "gzip magic number");
+    QVERIFY2(gz.size() < text.size() / 5, "log text is compressed");
+}
+
+void QLoggerTest::test_caseFileRetention()
+{
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_retention"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "retention test folder created");
+
+    // files left by a previous run are removed too
+    QStringList oldFiles;
+    for (int i = 0; i != 5; ++i)
+    {
+        oldFiles << dir.absoluteFilePath(QString("retention_retention_20180101_00000%1.log").arg(i));
+        QFile old(oldFiles.last());
+        QVERIFY2(old.open(QIODevice::WriteOnly), "old log file created");
+    }
+    // an owner whose name starts with this owner name keeps its files
+    QFile other(dir.absoluteFilePath("retention_retention_net_20180101_000000.log"));
+    QVERIFY2(other.open(QIODevice::WriteOnly) && other.write("another owner log\n") > 0, "other owner file created");
+    other.close();
+
+    const int maxFiles = 3;
+    Configuration* cfg = new Configuration("retention", q5TRACE, "%l %m", DEFAULT_TIMESTAMP_FORMAT,
+                                           "retention_%2_%3.log", "yyyyMMdd_hhmmss", dir.absolutePath(), 2000);
+    cfg->setMaxFiles(maxFiles);
+    QVERIFY2(cfg->hasRetention(), "retention enabled");
+    QLogger::addLogger(cfg, TEXTFILE);
+
+    for (int i = 0; i != 200; ++i)
+        QLOGF_TRACE("retention", "a log that fills the retention files n:%1", i);
+    QLogger::flush();
+
+    // the worker removes the files, the next file may already be opened ahead, still empty
+    auto writtenFiles = [&dir]()
+    {
+        int count = 0;
+        const QFileInfoList files = dir.entryInfoList(QStringList() << "retention_retention_2*", QDir::Files);
+        for (const QFileInfo &info : files)
+            count += info.size() > 0 ? 1 : 0;
+        return count;
+    };
+    QTRY_VERIFY2(writtenFiles() == maxFiles, "only the newest files are kept");
+    for (const QString &old : oldFiles)
+        QVERIFY2(!QFile::exists(old), "old files removed");
+    QVERIFY2(other.exists(), "the files of another owner are kept");
+}
+
+void QLoggerTest::test_caseBinaryOutput()
+{
+    QByteArray varint;
+    appendVarint(varint, 300);
+    QVERIFY2(varint == QByteArray("\xac\x02"), "varint low bits first");
+    quint64 value = 0;
+    const char *it = varint.constData();
+    QVERIFY2(readVarint(it, varint.constData() + varint.size(), value) && value == 300, "varint read back");
+    QVERIFY2(zigzagDecode(zigzagEncode(-1)) == -1 && zigzagEncode(-1) == 1, "zigzag of negative values");
+
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_binary"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "binary test folder created");
+
+    Configuration* cfg = new Configuration("binary", q5TRACE);
+    cfg->setFilePath(dir.absolutePath());
+    QLogger::addLogger(cfg, BINARY);
+
+    const int count = 100;
+    for (int i = 0; i != count; ++i)
+        QLOGF_INFO("binary", "a binary log n:%1 \u00e7", i);
+    QLOG_TRACE("the last binary log", "binary");
+    QLogger::flush();
+
+    QFileInfoList files = dir.entryInfoList(QStringList() << "*.qlog", QDir::Files);
+    QVERIFY2(files.size() == 1, "one binary file created");
+    QFile file(files.first().absoluteFilePath());
+    QVERIFY2(file.open(QIODevice::ReadOnly), "binary file opened");
+
+    BinaryLogReader reader(&file);
+    BinaryLogEntry entry;
+    int read = 0;
+    qint64 lastTimestamp = 0;
+    for (; read != count && reader.next(entry); )
+    {
+        QVERIFY2(entry.message == QString("a binary log n:%1 \u00e7").arg(read), "message read back");
+        QVERIFY2(entry.level == q3INFO && entry.owner == "binary", "level and owner read back");
+        QVERIFY2(entry.lineNumber > 0 && !entry.functionName.isEmpty(), "call site read back");
+        QVERIFY2(entry.timestamp >= lastTimestamp, "timestamps read back from the deltas");
+        lastTimestamp = entry.timestamp;
+        read++;
+    }
+    QVERIFY2(read == count, "all logs read back");
+    QVERIFY2(reader.next(entry) && entry.level == q5TRACE && entry.message == "the last binary log",
+             "last log read back");
+    QVERIFY2(!reader.next(entry) && !reader.hasError(), "binary file is valid to the end");
+}
+
+void QLoggerTest::test_caseJSONLines()
+{
+    QString escaped;
+    appendJsonString(escaped, QString("a \"quoted\" \\ text\n\t") + QChar(0x01));
+    QVERIFY2(escaped == "\"a \\\"quoted\\\" \\\\ text\\n\\t\\u0001\"", "json string escaped");
+
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_ndjson"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "ndjson test folder created");
+
+    Configuration* cfg = new Configuration("ndjson", q5TRACE);
+    cfg->setFilePath(dir.absolutePath());
+    cfg->setJsonFormat(jsonFormatFromString("lines"));
+    QLogger::addLogger(cfg, JSON);
+
+    const int count = 10;
+    for (int i = 0; i != count; ++i)
+        QLOGF_WARN("ndjson", "a \"json\" log\nn:%1", i);
+    QLogger::flush();
+
+    QFileInfoList files = dir.entryInfoList(QStringList() << "*.ndjson", QDir::Files);
+    QVERIFY2(files.size() == 1, "one ndjson file created");
+    QFile file(files.first().absoluteFilePath());
+    QVERIFY2(file.open(QIODevice::ReadOnly | QIODevice::Text), "ndjson file opened");
+    int lines = 0;
+    while (!file.atEnd())
+    {
+        QJsonParseError error;
+        QJsonDocument json = QJsonDocument::fromJson(file.readLine(), &error);
+        QVERIFY2(error.error == QJsonParseError::NoError && json.isObject(), "every line is a json object");
+        QJsonObject log = json.object();
+        QVERIFY2(log.value("message").toString() == QString("a \"json\" log\nn:%1").arg(lines), "message read back");
+        QVERIFY2(log.value("owner").toString() == "ndjson" && log.value("level").toString() == WARN_LEVEL,
+                 "owner and level read back");
+        lines++;
+    }
+    QVERIFY2(lines == count, "one line per log");
+}
+
+void QLoggerTest::test_caseBatchWrite()
+{
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_batch"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "batch test folder created");
+
+    const qint64 maxSize = 4000;
+    Configuration* cfg = new Configuration("batch", q5TRACE);
+    cfg->setFilePath(dir.absolutePath());
+    cfg->setFileMaxSizeInBytes(maxSize);
+    cfg->setJsonFormat(JSON_LINES);
+    QLogger::addLogger(cfg, JSON);
+
+    // the backend writes the queued logs in batches
+    QLogger::setAsynchronous(true);
+    const int count = 1000;
+    for (int i = 0; i != count; ++i)
+        QLOGF_INFO("batch", "a batched log n:%1", i);
+    QLogger::setAsynchronous(false);
+    QLogger::flush();
+
+    // the finished files get their last bytes from the file worker
+    auto readLogs = [&dir]()
+    {
+        QVector<int> logs;
+        for (const QFileInfo &info : dir.entryInfoList(QStringList() << "*.ndjson", QDir::Files))
+        {
+            QFile file(info.absoluteFilePath());
+            if (!file.open(QIODevice::ReadOnly))
+                continue;
+            while (!file.atEnd())
+            {
+                QJsonDocument json = QJsonDocument::fromJson(file.readLine());
+                QString message = json.object().value("message").toString();
+                logs.append(message.startsWith("a batched log n:") ? message.mid(16).toInt() : -1);
+            }
+        }
+        return logs;
+    };
+    QTRY_VERIFY2(readLogs().size() == count, "every batched log written");
+
+    QVector<int> logs = readLogs();
+    QVERIFY2(!logs.contains(-1), "no log split by the rotation");
+    std::sort(logs.begin(), logs.end());
+    for (int i = 0; i != count; ++i)
+        QVERIFY2(logs.at(i) == i, "every log written once");
+    for (const QFileInfo &file : dir.entryInfoList(QDir::Files))
+        QVERIFY2(file.size() <= maxSize, "no file goes over the max size");
+}
+
+void QLoggerTest::test_caseIsolatedOutput()
+{
+    const int capacity = 4;
+    Configuration* gatedCfg = new Configuration("isolated", q5TRACE);
+    gatedCfg->setIsolatedQueueCapacity(capacity);
+    GatedOutput *gated = new GatedOutput(gatedCfg);
+    QLogger::addLogger(gatedCfg, gated);
+    QLogger::addLogger("isolated", q5TRACE, SIGNAL);
+
+    std::atomic<int> healthy(0);
+    QMetaObject::Connection connection = connect(QLogger::getSignal("isolated"), &SignalOutput::qlogger,
+                                                 [&healthy](QString) { healthy++; });
+
+    // the isolated writer takes the first log and stays stuck on the output
+    QLOG_INFO("a log that holds the isolated writer", "isolated");
+    QVERIFY2(gated->entered.tryAcquire(1, 5000), "the isolated writer is writing");
+
+    // the queue fills up, the logging thread goes on without waiting for the stuck output
+    const int count = 100;
+    for (int i = 0; i != count; ++i)
+        QLOGF_INFO("isolated", "a log for a stuck and a healthy output n:%1", i);
+    const quint64 dropped = QLogger::getDroppedCount("isolated");
+    QVERIFY2(dropped == static_cast<quint64>(count - capacity), "the logs that found the queue full were dropped");
+
+    gated->gate.release(count + 1);
+    QLogger::flush();
+
+    disconnect(connection);
+    QVERIFY2(healthy == count + 1, "the healthy output got every log");
+    QVERIFY2(gated->count == capacity + 1, "the held log and the queued ones were written");
+}
+
+void QLoggerTest::test_caseOutputLocking()
+{
+    Configuration* slowCfg = new Configuration("lockslow", q5TRACE);
+    SlowOutput *slow = new SlowOutput(slowCfg);
+    QLogger::addLogger(slowCfg, slow);
+    Configuration* fastCfg = new Configuration("lockfast", q5TRACE);
+    SlowOutput *fast = new SlowOutput(fastCfg, 0);
+    QLogger::addLogger(fastCfg, fast);
+
+    // another thread keeps the slow output busy for a second
+    QThreadPool pool;
+    pool.start(new SlowOwnerLogger());
+    QTRY_VERIFY2(slow->count > 0, "the slow owner is being written");
+
+    const int count = 100;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i != count; ++i)
+        QLOG_INFO("a log for an unrelated owner", "lockfast");
+    QVERIFY2(timer.elapsed() < 500, "an unrelated owner does not wait for the slow output");
+    QVERIFY2(fast->count == count, "every log of the unrelated owner written");
+
+    pool.waitForDone();
+    QVERIFY2(slow->count == 50, "every log of the slow owner written");
+}
+
+void QLoggerTest::test_caseSnapshotReader()
+{
+    quint64 epoch = 0;
+    {
+        SnapshotReader reader;
+        epoch = SnapshotReader::retireEpoch();
+        QVERIFY2(!SnapshotReader::isReclaimable(epoch), "a snapshot replaced while this thread reads waits for it");
+        {
+            SnapshotReader nested;
+        }
+        QVERIFY2(!SnapshotReader::isReclaimable(epoch), "a nested reader does not end the read");
+
+        // the registry is replaced while this thread reads it
+        QVERIFY2(QLogger::getLogger("snapshot") == QLogger::getLogger("snapshot"), "the new owner is found");
+    }
+    // other threads may be reading on the same epoch for a moment
+    QTRY_VERIFY2(SnapshotReader::isReclaimable(epoch), "reclaimed once the readers ended");
+
+    QLogger::addLogger("snapshot", q5TRACE, SIGNAL);
+    QVERIFY2(QLogger::getSignal("snapshot") != nullptr, "the new output list is published");
+    QLogger::addLogger("snapshot", q5TRACE, SIGNAL);
+    QVERIFY2(QLogger::getSignal("snapshot") != nullptr, "the old output list is retired, not lost");
+}
+
+void QLoggerTest::test_caseConfigurationReload()
+{
+    QDir dir(QDir::temp().absoluteFilePath("qlogger_reload"));
+    dir.removeRecursively();
+    QVERIFY2(dir.mkpath("."), "reload test folder created");
+    // back to the folder and the configuration file of the other tests even when a check fails
+    struct CurrentPathGuard
+    {
+        const QString path = QDir::currentPath();
+        ~CurrentPathGuard()
+        {
+            QLogger::watchConfigurationFile(false);
+            QDir::setCurrent(path);
+            QLogger::reloadConfigurationFile();
+        }
+    } startPath;
+    QDir::setCurrent(dir.absolutePath());
+
+    auto writeIni = [&dir](const QByteArray &text)
+    {
+        QFile ini(dir.absoluteFilePath(CH_CONFIG_FILE_NAME));
+        return ini.open(QIODevice::WriteOnly | QIODevice::Truncate) && ini.write(text) == text.size();
+    };
+
+    QVERIFY2(writeIni("[reload]\nlevel=warn\noutputType=signal\n"), "configuration file written");
+    QLogger::reloadConfigurationFile();
+    SignalOutput *sig = QLogger::getSignal("reload");
+    QVERIFY2(sig != nullptr, "an owner added to the file is added");
+    QVERIFY2(QLogger::isEnabled(q2WARN, "reload") && !QLogger::isEnabled(q3INFO, "reload"), "owner level read");
+
+    QVERIFY2(writeIni("[reload]\nlevel=trace\noutputType=signal\nlogMask=%l %m\n"), "configuration file written");
+    QLogger::reloadConfigurationFile();
+    QVERIFY2(QLogger::isEnabled(q5TRACE, "reload"), "level changed");
+    QVERIFY2(QLogger::getSignal("reload") == sig, "a level or mask change keeps the running output");
+    QVERIFY2(sig->getConfiguration()->getLogTextMask() == "%l %m", "mask changed on the running output");
+
+    QVERIFY2(writeIni("[reload]\nlevel=trace\noutputType=signal\nlogMask=%l %m\nfileName=reload_%1.log\n"),
+             "configuration file written");
+    QLogger::reloadConfigurationFile();
+    sig = QLogger::getSignal("reload");
+    QVERIFY2(sig != nullptr && sig->getConfiguration()->getFileNameMask() == "reload_%1.log", "output replaced");
+    {
+        SnapshotReader reader;
+        QVERIFY2(QLogger::getLogger("reload")->getOutputs()->size() == 1, "the old output is not kept");
+    }
+
+    QVERIFY2(writeIni("[reload2]\nlevel=info\noutputType=signal\n"), "configuration file written");
+    QLogger::reloadConfigurationFile();
+    QVERIFY2(!QLogger::isEnabled(q0FATAL, "reload") && QLogger::getSignal("reload") == nullptr, "owner removed");
+    QVERIFY2(QLogger::isEnabled(q3INFO, "reload2"), "owner added");
+
+    // the watcher reads the file when it is saved, on the event loop QTRY_VERIFY runs
+    QLogger::watchConfigurationFile(true);
+    QVERIFY2(writeIni("[reload2]\nlevel=debug\noutputType=signal\n"), "configuration file written");
+    QTRY_VERIFY2(QLogger::isEnabled(q4DEBUG, "reload2"), "level changed by the watcher");
+    QLogger::watchConfigurationFile(false);
+
+    QVERIFY2(QFile::remove(dir.absoluteFilePath(CH_CONFIG_FILE_NAME)), "configuration file deleted");
+    QLogger::reloadConfigurationFile();
+    QVERIFY2(!QLogger::isEnabled(q0FATAL, "reload2") && QLogger::getSignal("reload2") == nullptr,
+             "the owners of a deleted file are removed");
+}
+
+void QLoggerTest::test_caseTextEscape()
+{
+    const QByteArray kernel(escapeKernel());
+    QVERIFY2(kernel == "avx2" || kernel == "sse2" || kernel == "scalar", "an escape scanner was chosen");
+
+    // a character to escape on every position of blocks of every size, for the simd and the scalar tails
+    for (int size = 1; size != 48; ++size)
+    {
+        for (int at = 0; at != size; ++at)
+        {
+            QString text(size, QChar('a'));
+            text[at] = QChar('"');
+            QVERIFY2(findJsonEscape(text.constData(), text.constData() + size) == text.constData() + at, "json escape found");
+            QVERIFY2(findXmlEscape(text.constData(), text.constData() + size) == text.constData() + size, "quotes are fine on xml text");
+            text[at] = QChar(0x0b);
+            QVERIFY2(findXmlEscape(text.constData(), text.constData() + size) == text.constData() + at, "xml escape found");
+            text[at] = QChar(0x2022);
+            QVERIFY2(findJsonEscape(text.constData(), text.constData() + size) == text.constData() + size, "no json escape");
+        }
+    }
+
+    QString xml;
+    appendXmlText(xml, QString("a <tag> & \"text\"\n"));
+    QVERIFY2(xml == "a &lt;tag&gt; &amp; \"text\"\n", "xml text escaped");
+}
+
+void QLoggerTest::test_caseEscapeBenchmark_data()
+{
+    QTest::addColumn<int>("kind");
+    QTest::newRow("unescaped") << 0;
+    QTest::newRow("json") << 1;
+    QTest::newRow("xml") << 2;
+}
+
+void QLoggerTest::test_caseEscapeBenchmark()
+{
+    QFETCH(int, kind);
+    const QString message("a typical log message of an application, value n:12345 was processed in 42 ms by worker 7");
+    QString buffer;
+    QBENCHMARK
+    {
+        buffer.resize(0);
+        switch (kind)
+        {
+            case 0: buffer += message; break;
+            case 1: appendJsonString(buffer, message); break;
+            case 2: appendXmlText(buffer, message); break;
+        }
+    }
+    QVERIFY2(buffer.size() >= message.size(), "message appended");
+}
+
+void QLoggerTest::test_caseUtf8Pipeline()
+{
+    const QString text = QString("ascii ç€ ") + QChar(0xd83d) + QChar(0xde00) + " lone " + QChar(0xd800);
+    QByteArray bytes("prefix ");
+    appendUtf8(bytes, text);
+    QVERIFY2(bytes == "prefix " + text.toUtf8(), "encoded like QString::toUtf8, lone surrogates too");
+
+    QByteArray number;
+    appendNumber(number, -2147483647 - 1);
+    appendNumber(number, 0);
+    QVERIFY2(number == "-21474836480", "numbers appended");
+
+    TimestampFormatter formatter(DEFAULT_TIMESTAMP_FORMAT, false);
+    const qint64 timestamp = Q_INT64_C(1540000000007000000);
+    QVERIFY2(formatter.formatUtf8(timestamp) == formatter.format(timestamp).toUtf8(), "timestamp encoded");
+
+    LogTextMask mask("%t [%o] <%l> (%f) {line:%n} - ç %m");
+    QString line;
+    mask.format(line, text, "owner ç", WARN_LEVEL, "now", "function", 42);
+    QByteArray lineUtf8;
+    mask.format(lineUtf8, text, QString("owner ç").toUtf8(), levelToUtf8(q2WARN), "now", "function", 42);
+    QVERIFY2(lineUtf8 == line.toUtf8(), "the mask formats the same text as UTF-8");
+
+    QByteArray json;
+    appendJsonString(json, text);
+    QString jsonText;
+    appendJsonString(jsonText, text);
+    QVERIFY2(json == jsonText.toUtf8(), "json string escaped as UTF-8");
+
+    // texts already UTF-8, as the timestamps and the owner names
+    const QString special = QString("\"<ç & \\>\"") + QChar(0x01);
+    QByteArray jsonUtf8;
+    appendJsonUtf8(jsonUtf8, special.toUtf8());
+    QString jsonSpecial;
+    appendJsonString(jsonSpecial, special);
+    QVERIFY2(jsonUtf8 == jsonSpecial.toUtf8(), "UTF-8 json string escaped like the text");
+    QByteArray xmlUtf8;
+    appendXmlUtf8(xmlUtf8, special.toUtf8());
+    QString xmlSpecial;
+    appendXmlText(xmlSpecial, special);
+    QVERIFY2(xmlUtf8 == xmlSpecial.toUtf8(), "UTF-8 xml text escaped like the text");
+
+    Configuration lineEndings("lineEndings");
+    QVERIFY2(lineEndings.isNativeLineEndings(), "text files keep the platform line endings by default");
+}
+
 void QLoggerTest::test_caseHeavyLoadFileTest()
 {
     QLogger::addLogger("heavy", q1ERROR, TEXTFILE);
@@ -377,6 +1165,68 @@ void QLoggerTest::test_caseThreadHeavyLoadTest()
     //*/
 }
 
+void QLoggerTest::test_caseAsyncThreadHeavyLoadTest()
+{
+    /*
+    //same load as test_caseThreadHeavyLoadTest but on asynchronous mode, compare the elapsed times
+    QLogger::addLogger("threads");
+    QLogger::setAsynchronous(true);
+    QThreadPool::globalInstance()->start(new LoggerA);
+    QThreadPool::globalInstance()->start(new LoggerB);
+    QThreadPool::globalInstance()->waitForDone();
+    QLogger::setAsynchronous(false); // writes whatever is still queued
+    //*/
+}
+
+void QLoggerTest::test_caseAsyncThreadOrder()
+{
+    Configuration* cfg = new Configuration("asyncorder", q5TRACE, "%m");
+    QLogger::addLogger(cfg, SIGNAL);
+
+    QMutex received;
+    QStringList logs;
+    QMetaObject::Connection connection = connect(QLogger::getSignal("asyncorder"), &SignalOutput::qlogger,
+                                                 [&received, &logs](QString text)
+    {
+        QMutexLocker locker(&received);
+        logs.append(text.trimmed());
+    });
+
+    const int threads = 4;
+    const int count = 2000;
+    QThreadPool pool;
+    QLogger::setAsynchronous(true);
+    QVERIFY2(QLogger::isAsynchronous(), "asynchronous mode on");
+    for (int t = 0; t != threads; ++t)
+        pool.start(new NumberedLogger(t, count));
+    pool.waitForDone();
+    QLogger::setAsynchronous(false); // writes whatever is still queued
+    QVERIFY2(!QLogger::isAsynchronous(), "asynchronous mode off");
+
+    QVERIFY2(logs.size() == threads * count, "every log reached the output");
+    QVector<int> next(threads, 0);
+    bool ordered = true;
+    for (const QString &text : logs)
+    {
+        const QStringList fields = text.split(' ');
+        const int t = fields.value(0).mid(2).toInt();
+        const int n = fields.value(1).mid(2).toInt();
+        if (t < 0 || t >= threads || n != next[t]++)
+            ordered = false;
+    }
+    QVERIFY2(ordered, "the logs of each thread are written in the order they were logged");
+
+    // turned off while the threads are logging, no log is left behind on the queue
+    logs.clear();
+    QLogger::setAsynchronous(true);
+    for (int t = 0; t != threads; ++t)
+        pool.start(new NumberedLogger(t, count));
+    QLogger::setAsynchronous(false);
+    pool.waitForDone();
+    disconnect(connection);
+    QVERIFY2(logs.size() == threads * count, "every log reached the output after the switch");
+}
+
 QTEST_MAIN(QLoggerTest)
 
 #include "tst_qloggertest.moc"